@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NPU_PMU_COUNTERS_HPP
+#define NPU_PMU_COUNTERS_HPP
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Ethos-U PMU counts accumulated over one or more NPU invocations.
+     *          On U55 and U65 only four event counters exist and the fourth counts AXI1 reads
+     *          only. The U55 AXI1 port is read only, but writes on the read/write AXI1 port of
+     *          U65 are not counted. On U85 the two ports are the SRAM and external memory
+     *          interfaces.
+     */
+    struct NpuPmuCounters {
+        uint64_t totalCycles{0};    /**< NPU cycle counter while inferences were running. */
+        uint64_t activeCycles{0};   /**< Cycles the NPU was busy. */
+        uint64_t idleCycles{0};     /**< Cycles the NPU was waiting, e.g. on memory. */
+        uint64_t axi0ReadBeats{0};  /**< Data beats read on AXI0 (U85: SRAM). */
+        uint64_t axi0WriteBeats{0}; /**< Data beats written on AXI0 (U85: SRAM). */
+        uint64_t axi1ReadBeats{0};  /**< Data beats read on AXI1 (U85: external). */
+        uint64_t axi1WriteBeats{0}; /**< Data beats written on AXI1 (U85 only: external). */
+        uint32_t invocations{0};    /**< Number of NPU command streams run. */
+    };
+
+    /**
+     * @brief   Gets the PMU counts accumulated since the previous call and clears them.
+     *          The counters are set up and read around every NPU invocation by the
+     *          ethosu_inference_begin/end driver hooks; nothing is counted without an NPU.
+     */
+    NpuPmuCounters TakeNpuPmuCounters();
+
+    /**
+     * @brief       Prints the counts as one "npu_pmu," prefixed CSV line, printing the
+     *              header line first on the first call.
+     * @param[in]   counters          Counts to print.
+     * @param[in]   inferenceNumber   Value for the inference column.
+     * @param[in]   cpuTicks          CPU ticks spent in the inference.
+     */
+    void PrintNpuPmuCounters(const NpuPmuCounters& counters,
+                             uint32_t inferenceNumber,
+                             uint32_t cpuTicks);
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* NPU_PMU_COUNTERS_HPP */
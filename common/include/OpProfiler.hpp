@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OP_PROFILER_HPP
+#define OP_PROFILER_HPP
+
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/* Set to 1 to time every operator and print the results as CSV after each inference. */
+#if !defined(ML_OP_PROFILING)
+#define ML_OP_PROFILING 0
+#endif /* !defined(ML_OP_PROFILING) */
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Op resolver that wraps the registrations of another resolver so that every
+     *          operator invocation is timed. The model API does not give access to the
+     *          interpreter's profiler hook, so the timing is inserted at the op level instead.
+     *          Records are kept in one process-wide log in invocation order, which is also
+     *          the operator order of the graph.
+     */
+    class OpProfilingResolver : public tflite::MicroOpResolver {
+    public:
+        /** Maximum number of distinct operator types that can be profiled. */
+        static constexpr size_t ms_maxOpTypes = 16;
+
+        /** Maximum number of operator invocations recorded between two prints. */
+        static constexpr size_t ms_maxRecords = 256;
+
+        /**
+         * @brief       Sets the resolver whose registrations are wrapped.
+         * @param[in]   resolver   Resolver of the model; must outlive this object.
+         */
+        void SetResolver(const tflite::MicroOpResolver* resolver);
+
+        const TFLMRegistration* FindOp(tflite::BuiltinOperator op) const override;
+        const TFLMRegistration* FindOp(const char* op) const override;
+        TfLiteBridgeBuiltinParseFunction
+        GetOpDataParser(tflite::BuiltinOperator op) const override;
+
+        /**
+         * @brief       Prints the operators recorded since the last call as CSV lines
+         *              (prefixed with "op_csv,") and clears the log.
+         * @param[in]   inferenceNumber   Value for the inference column.
+         */
+        static void PrintCsv(uint32_t inferenceNumber);
+
+    private:
+        const tflite::MicroOpResolver* m_resolver{nullptr};
+    };
+
+    /**
+     * @brief   Model of type ModelT with every operator timed by an OpProfilingResolver.
+     * @tparam  ModelT   Model class from the use case API, e.g. MicroNetKwsModel.
+     */
+    template <typename ModelT>
+    class OpProfilingModel : public ModelT {
+    protected:
+        const tflite::MicroOpResolver& GetOpResolver() override
+        {
+            this->m_profilingResolver.SetResolver(&ModelT::GetOpResolver());
+            return this->m_profilingResolver;
+        }
+
+    private:
+        OpProfilingResolver m_profilingResolver;
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* OP_PROFILER_HPP */
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAGE_PROFILER_HPP
+#define STAGE_PROFILER_HPP
+
+#include "tensorflow/lite/micro/micro_time.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Tick statistics of one profiled stage. Count, min, mean and max cover every
+     *          sample; percentiles are taken over the most recent ms_maxSamples samples.
+     */
+    class StageStats {
+    public:
+        /** Number of recent samples kept for the percentiles. */
+        static constexpr size_t ms_maxSamples = 128;
+
+        /**
+         * @brief       Adds one measurement.
+         * @param[in]   ticks   Ticks spent in the stage.
+         */
+        void Add(uint32_t ticks);
+
+        uint32_t GetCount() const { return this->m_count; }
+        uint32_t GetLast() const
+        {
+            return this->m_count ? this->m_samples[(this->m_count - 1) % ms_maxSamples] : 0;
+        }
+        uint32_t GetMin() const { return this->m_count ? this->m_min : 0; }
+        uint32_t GetMax() const { return this->m_max; }
+        uint64_t GetTotal() const { return this->m_total; }
+        double GetMean() const;
+
+        /**
+         * @brief       Gets a percentile of the recent samples (nearest rank).
+         * @param[in]   percent   Percentile, 0 to 100.
+         * @return      Ticks at the percentile, 0 if there are no samples.
+         */
+        uint32_t GetPercentile(uint32_t percent) const;
+
+    private:
+        uint32_t m_samples[ms_maxSamples]{};
+        uint32_t m_count{0};
+        uint32_t m_min{UINT32_MAX};
+        uint32_t m_max{0};
+        uint64_t m_total{0};
+    };
+
+    /**
+     * @brief   Collects tick statistics for a small fixed set of named application stages
+     *          and prints them as a Markdown table in the layout of PerformanceResults.md.
+     *          Ticks come from tflite::GetCurrentTimeTicks().
+     */
+    class StageProfiler {
+    public:
+        /** Maximum number of stages that can be registered. */
+        static constexpr size_t ms_maxStages = 8;
+
+        StageProfiler() = default;
+
+        /**
+         * @brief       Registers a stage.
+         * @param[in]   name   Column heading for the stage; must outlive the profiler.
+         * @return      Stage index to time against, ms_maxStages if there is no room left.
+         */
+        size_t AddStage(const char* name);
+
+        /**
+         * @brief       Adds one measurement to a stage. Out of range indices are ignored.
+         * @param[in]   stage   Index returned by AddStage.
+         * @param[in]   ticks   Ticks spent in the stage.
+         */
+        void Record(size_t stage, uint32_t ticks);
+
+        /**
+         * @brief       Gets the statistics of a stage.
+         * @param[in]   stage   Index returned by AddStage; must be valid.
+         */
+        const StageStats& GetStats(size_t stage) const { return this->m_stats[stage]; }
+
+        /**
+         * @brief       Prints one table with a column per stage. The first row holds the mean
+         *              times under the target name and can be pasted into the results as is;
+         *              min, percentile and max rows follow.
+         *              Raw ticks are printed if ticksPerSecond is zero.
+         * @param[in]   targetName       Row heading, e.g. the target type.
+         * @param[in]   ticksPerSecond   Tick frequency, usually tflite::ticks_per_second().
+         */
+        void PrintSummary(const char* targetName, uint32_t ticksPerSecond) const;
+
+    private:
+        const char* m_names[ms_maxStages]{};
+        StageStats m_stats[ms_maxStages]{};
+        size_t m_numStages{0};
+    };
+
+    /**
+     * @brief   Records the ticks between its construction and destruction against a stage.
+     */
+    class ScopedStageTimer {
+    public:
+        ScopedStageTimer(StageProfiler& profiler, size_t stage)
+            : m_profiler{profiler}, m_stage{stage}, m_start{tflite::GetCurrentTimeTicks()}
+        {}
+
+        ~ScopedStageTimer()
+        {
+            this->m_profiler.Record(this->m_stage, tflite::GetCurrentTimeTicks() - this->m_start);
+        }
+
+        ScopedStageTimer(const ScopedStageTimer&)            = delete;
+        ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+    private:
+        StageProfiler& m_profiler;
+        size_t m_stage;
+        uint32_t m_start;
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* STAGE_PROFILER_HPP */
@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NpuPmuCounters.hpp"
+
+#include "RTE_Components.h" /* Defines ETHOSU_ARCH when the NPU driver is in the build */
+
+#include <cinttypes>
+#include <cstdio>
+
+#if defined(ETHOSU_ARCH)
+#include "ethosu_driver.h" /* Arm Ethos-U NPU driver header */
+#include "pmu_ethosu.h"    /* Arm Ethos-U NPU PMU helpers */
+
+namespace {
+
+    /* Event counters in use; counter 0 counts active cycles. */
+#if defined(ETHOSU85)
+    constexpr ethosu_pmu_event_type s_events[] = {ETHOSU_PMU_NPU_ACTIVE,
+                                                  ETHOSU_PMU_SRAM_RD_DATA_BEAT_RECEIVED,
+                                                  ETHOSU_PMU_SRAM_WR_DATA_BEAT_WRITTEN,
+                                                  ETHOSU_PMU_EXT_RD_DATA_BEAT_RECEIVED,
+                                                  ETHOSU_PMU_EXT_WR_DATA_BEAT_WRITTEN};
+#else  /* defined(ETHOSU85) */
+    /* Only four event counters: the fourth counts AXI1 reads alone. That covers the read only
+     * AXI1 port of U55, but writes on the read/write AXI1 port of U65 go uncounted. */
+    constexpr ethosu_pmu_event_type s_events[] = {ETHOSU_PMU_NPU_ACTIVE,
+                                                  ETHOSU_PMU_AXI0_RD_DATA_BEAT_RECEIVED,
+                                                  ETHOSU_PMU_AXI0_WR_DATA_BEAT_WRITTEN,
+                                                  ETHOSU_PMU_AXI1_RD_DATA_BEAT_RECEIVED};
+#endif /* defined(ETHOSU85) */
+    constexpr uint32_t s_numEvents = sizeof(s_events) / sizeof(s_events[0]);
+
+    arm::app::NpuPmuCounters s_counters;
+
+} /* namespace */
+
+extern "C" {
+
+/* Overrides the weak driver hook: starts counting at the beginning of each command stream. */
+void ethosu_inference_begin(struct ethosu_driver* drv, void* /* user_arg */)
+{
+    ETHOSU_PMU_Enable(drv);
+    for (uint32_t i = 0; i < s_numEvents; ++i) {
+        ETHOSU_PMU_Set_EVTYPER(drv, i, s_events[i]);
+    }
+    ETHOSU_PMU_CYCCNT_Reset(drv);
+    ETHOSU_PMU_EVCNTR_ALL_Reset(drv);
+    ETHOSU_PMU_CNTR_Enable(drv, ETHOSU_PMU_CCNT_Msk | ((1u << s_numEvents) - 1));
+}
+
+/* Overrides the weak driver hook: stops counting and accumulates the counts. */
+void ethosu_inference_end(struct ethosu_driver* drv, void* /* user_arg */)
+{
+    ETHOSU_PMU_CNTR_Disable(drv, ETHOSU_PMU_CCNT_Msk | ((1u << s_numEvents) - 1));
+
+    const uint64_t cycles = ETHOSU_PMU_Get_CCNTR(drv);
+    const uint32_t active = ETHOSU_PMU_Get_EVCNTR(drv, 0);
+
+    s_counters.totalCycles += cycles;
+    s_counters.activeCycles += active;
+    s_counters.idleCycles += cycles > active ? cycles - active : 0;
+    s_counters.axi0ReadBeats += ETHOSU_PMU_Get_EVCNTR(drv, 1);
+    s_counters.axi0WriteBeats += ETHOSU_PMU_Get_EVCNTR(drv, 2);
+    s_counters.axi1ReadBeats += ETHOSU_PMU_Get_EVCNTR(drv, 3);
+#if defined(ETHOSU85)
+    s_counters.axi1WriteBeats += ETHOSU_PMU_Get_EVCNTR(drv, 4);
+#endif /* defined(ETHOSU85) */
+    ++s_counters.invocations;
+
+    ETHOSU_PMU_Disable(drv);
+}
+
+} /* extern "C" */
+#endif /* defined(ETHOSU_ARCH) */
+
+namespace arm {
+namespace app {
+
+    NpuPmuCounters TakeNpuPmuCounters()
+    {
+#if defined(ETHOSU_ARCH)
+        const NpuPmuCounters counters = s_counters;
+        s_counters                    = NpuPmuCounters{};
+        return counters;
+#else  /* defined(ETHOSU_ARCH) */
+        return NpuPmuCounters{};
+#endif /* defined(ETHOSU_ARCH) */
+    }
+
+    void PrintNpuPmuCounters(const NpuPmuCounters& counters,
+                             uint32_t inferenceNumber,
+                             uint32_t cpuTicks)
+    {
+        static bool headerPrinted = false;
+        if (!headerPrinted) {
+            printf("npu_pmu,inference,cpu_ticks,npu_invocations,npu_cycles,npu_active,npu_idle,"
+                   "axi0_rd_beats,axi0_wr_beats,axi1_rd_beats,axi1_wr_beats\n");
+            headerPrinted = true;
+        }
+
+        printf("npu_pmu,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+               ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",",
+               inferenceNumber,
+               cpuTicks,
+               counters.invocations,
+               counters.totalCycles,
+               counters.activeCycles,
+               counters.idleCycles,
+               counters.axi0ReadBeats,
+               counters.axi0WriteBeats,
+               counters.axi1ReadBeats);
+
+        /* Left empty where AXI1 writes are not counted, rather than reported as none. */
+#if defined(ETHOSU85)
+        printf("%" PRIu64 "\n", counters.axi1WriteBeats);
+#else  /* defined(ETHOSU85) */
+        printf("\n");
+#endif /* defined(ETHOSU85) */
+    }
+
+} /* namespace app */
+} /* namespace arm */
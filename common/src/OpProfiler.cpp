@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "OpProfiler.hpp"
+
+#include "tensorflow/lite/micro/micro_time.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace arm {
+namespace app {
+
+    namespace {
+
+        using InvokeFn = TfLiteStatus (*)(TfLiteContext*, TfLiteNode*);
+
+        /* A wrapped registration and the invoke function it replaced. */
+        struct ProfiledOp {
+            const TFLMRegistration* original;
+            TFLMRegistration wrapped;
+            const char* name;
+            bool onNpu;
+        };
+
+        struct OpRecord {
+            uint8_t opType;
+            uint32_t ticks;
+        };
+
+        ProfiledOp s_ops[OpProfilingResolver::ms_maxOpTypes];
+        size_t s_numOps{0};
+        OpRecord s_records[OpProfilingResolver::ms_maxRecords];
+        size_t s_numRecords{0};
+        uint32_t s_droppedRecords{0};
+
+        TfLiteStatus InvokeProfiled(size_t opType, TfLiteContext* context, TfLiteNode* node)
+        {
+            const uint32_t start      = tflite::GetCurrentTimeTicks();
+            const TfLiteStatus status = s_ops[opType].original->invoke(context, node);
+            const uint32_t ticks      = tflite::GetCurrentTimeTicks() - start;
+
+            if (s_numRecords < OpProfilingResolver::ms_maxRecords) {
+                s_records[s_numRecords++] = {static_cast<uint8_t>(opType), ticks};
+            } else {
+                ++s_droppedRecords;
+            }
+            return status;
+        }
+
+        /* Registrations carry no user data for invoke, so each op type gets its own entry
+         * point that knows its slot. */
+        template <size_t OpType>
+        TfLiteStatus InvokeSlot(TfLiteContext* context, TfLiteNode* node)
+        {
+            return InvokeProfiled(OpType, context, node);
+        }
+
+        template <size_t... OpTypes>
+        constexpr std::array<InvokeFn, sizeof...(OpTypes)>
+        MakeInvokeSlots(std::index_sequence<OpTypes...>)
+        {
+            return {&InvokeSlot<OpTypes>...};
+        }
+
+        constexpr auto s_invokeSlots =
+            MakeInvokeSlots(std::make_index_sequence<OpProfilingResolver::ms_maxOpTypes>{});
+
+        const TFLMRegistration* Wrap(const TFLMRegistration* registration)
+        {
+            if (!registration || !registration->invoke) {
+                return registration;
+            }
+
+            for (size_t i = 0; i < s_numOps; ++i) {
+                if (s_ops[i].original == registration) {
+                    return &s_ops[i].wrapped;
+                }
+            }
+
+            /* Out of slots: the op still runs, it just is not timed. */
+            if (s_numOps == OpProfilingResolver::ms_maxOpTypes) {
+                return registration;
+            }
+
+            ProfiledOp& op    = s_ops[s_numOps];
+            op.original       = registration;
+            op.wrapped        = *registration;
+            op.wrapped.invoke = s_invokeSlots[s_numOps];
+            if (registration->custom_name) {
+                op.name  = registration->custom_name;
+                op.onNpu = 0 == std::strcmp(registration->custom_name, "ethos-u");
+            } else {
+                op.name = tflite::EnumNameBuiltinOperator(
+                    static_cast<tflite::BuiltinOperator>(registration->builtin_code));
+                op.onNpu = false;
+            }
+            return &s_ops[s_numOps++].wrapped;
+        }
+
+    } /* namespace */
+
+    void OpProfilingResolver::SetResolver(const tflite::MicroOpResolver* resolver)
+    {
+        this->m_resolver = resolver;
+    }
+
+    const TFLMRegistration* OpProfilingResolver::FindOp(tflite::BuiltinOperator op) const
+    {
+        return this->m_resolver ? Wrap(this->m_resolver->FindOp(op)) : nullptr;
+    }
+
+    const TFLMRegistration* OpProfilingResolver::FindOp(const char* op) const
+    {
+        return this->m_resolver ? Wrap(this->m_resolver->FindOp(op)) : nullptr;
+    }
+
+    TfLiteBridgeBuiltinParseFunction
+    OpProfilingResolver::GetOpDataParser(tflite::BuiltinOperator op) const
+    {
+        return this->m_resolver ? this->m_resolver->GetOpDataParser(op) : nullptr;
+    }
+
+    void OpProfilingResolver::PrintCsv(uint32_t inferenceNumber)
+    {
+        static bool headerPrinted = false;
+        if (!headerPrinted) {
+            printf("op_csv,inference,op_index,op_name,placement,ticks\n");
+            headerPrinted = true;
+        }
+
+        for (size_t i = 0; i < s_numRecords; ++i) {
+            const ProfiledOp& op = s_ops[s_records[i].opType];
+            printf("op_csv,%" PRIu32 ",%zu,%s,%s,%" PRIu32 "\n",
+                   inferenceNumber,
+                   i,
+                   op.name,
+                   op.onNpu ? "NPU" : "CPU",
+                   s_records[i].ticks);
+        }
+
+        if (s_droppedRecords) {
+            printf("op_csv,%" PRIu32 ",,dropped,,%" PRIu32 "\n", inferenceNumber, s_droppedRecords);
+        }
+
+        s_numRecords     = 0;
+        s_droppedRecords = 0;
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StageProfiler.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace arm {
+namespace app {
+
+    void StageStats::Add(uint32_t ticks)
+    {
+        this->m_samples[this->m_count % ms_maxSamples] = ticks;
+        ++this->m_count;
+        this->m_min = std::min(this->m_min, ticks);
+        this->m_max = std::max(this->m_max, ticks);
+        this->m_total += ticks;
+    }
+
+    double StageStats::GetMean() const
+    {
+        return this->m_count ? static_cast<double>(this->m_total) / this->m_count : 0.0;
+    }
+
+    uint32_t StageStats::GetPercentile(uint32_t percent) const
+    {
+        const size_t n = std::min<size_t>(this->m_count, ms_maxSamples);
+        if (n == 0) {
+            return 0;
+        }
+
+        uint32_t sorted[ms_maxSamples];
+        std::copy(this->m_samples, this->m_samples + n, sorted);
+
+        /* Nearest rank: the smallest sample with at least percent% of samples at or below. */
+        const size_t rank = std::max<size_t>((std::min<uint32_t>(percent, 100) * n + 99) / 100, 1);
+        std::nth_element(sorted, sorted + rank - 1, sorted + n);
+        return sorted[rank - 1];
+    }
+
+    size_t StageProfiler::AddStage(const char* name)
+    {
+        if (this->m_numStages == ms_maxStages) {
+            return ms_maxStages;
+        }
+        this->m_names[this->m_numStages] = name;
+        return this->m_numStages++;
+    }
+
+    void StageProfiler::Record(size_t stage, uint32_t ticks)
+    {
+        if (stage < this->m_numStages) {
+            this->m_stats[stage].Add(ticks);
+        }
+    }
+
+    /* Prints a time with three significant figures, as in PerformanceResults.md. */
+    static void PrintCell(double ticks, uint32_t ticksPerSecond)
+    {
+        if (ticksPerSecond == 0) {
+            printf(" %.0f |", ticks);
+            return;
+        }
+
+        const double ms = ticks * 1000.0 / ticksPerSecond;
+        if (ms >= 100.0) {
+            printf(" %.0fms |", ms);
+        } else {
+            printf(" %.3gms |", ms);
+        }
+    }
+
+    void StageProfiler::PrintSummary(const char* targetName, uint32_t ticksPerSecond) const
+    {
+        printf("\n| |");
+        for (size_t i = 0; i < this->m_numStages; ++i) {
+            printf(" **%s** |", this->m_names[i]);
+        }
+
+        printf("\n|---|");
+        for (size_t i = 0; i < this->m_numStages; ++i) {
+            printf("---|");
+        }
+
+        /* Mean row, as in PerformanceResults.md. */
+        if (ticksPerSecond) {
+            printf("\n| **%s** (%" PRIu32 "MHz) |", targetName, ticksPerSecond / 1000000);
+        } else {
+            printf("\n| **%s** (ticks) |", targetName);
+        }
+        for (size_t i = 0; i < this->m_numStages; ++i) {
+            PrintCell(this->m_stats[i].GetMean(), ticksPerSecond);
+        }
+
+        printf("\n| min |");
+        for (size_t i = 0; i < this->m_numStages; ++i) {
+            PrintCell(this->m_stats[i].GetMin(), ticksPerSecond);
+        }
+
+        for (const uint32_t percent : {50, 90, 99}) {
+            printf("\n| p%" PRIu32 " |", percent);
+            for (size_t i = 0; i < this->m_numStages; ++i) {
+                PrintCell(this->m_stats[i].GetPercentile(percent), ticksPerSecond);
+            }
+        }
+
+        printf("\n| max |");
+        for (size_t i = 0; i < this->m_numStages; ++i) {
+            PrintCell(this->m_stats[i].GetMax(), ticksPerSecond);
+        }
+
+        printf("\n| count |");
+        for (size_t i = 0; i < this->m_numStages; ++i) {
+            printf(" %" PRIu32 " |", this->m_stats[i].GetCount());
+        }
+        printf("\n\n");
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -24,6 +24,9 @@
 #endif
 #include CMSIS_device_header
 #include "arm_vsi.h"
+#include "device_definition.h"
+#include "syscounter_armv8-m_cntrl_drv.h"
+#include "systimer_armv8-m_drv.h"
 
 // Video channel definitions
 #ifndef VIDEO_INPUT_CHANNELS
@@ -67,6 +70,11 @@
 #define Reg_FRAME_INDEX         Regs[10] // Frame index
 #define Reg_FRAME_COUNT         Regs[11] // Frame count
 #define Reg_FRAME_COUNT_MAX     Regs[12] // Frame count maximum
+#define Reg_FRAME_SLICES        Regs[13] // Number of DMA slices per frame
+#define Reg_TENSOR_LAYOUT       Regs[14] // Tensor layout: 0=none (color format)
+#define Reg_TENSOR_SIGNED       Regs[15] // Tensor elements signed
+#define Reg_TENSOR_ZERO_POINT   Regs[16] // Tensor zero point
+#define Reg_TENSOR_SCALE        Regs[17] // Tensor scale (IEEE 754 single precision)
 
 // Video MODE register defintions
 #define Reg_MODE_IO_Pos                 0U
@@ -105,11 +113,14 @@
 #define Reg_IRQ_Status_UNDERFLOW_Msk    (1UL << Reg_IRQ_Status_UNDERFLOW_Pos)
 #define Reg_IRQ_Status_EOS_Pos          3U
 #define Reg_IRQ_Status_EOS_Msk          (1UL << Reg_IRQ_Status_EOS_Pos)
+#define Reg_IRQ_Status_SLICE_Pos        4U
+#define Reg_IRQ_Status_SLICE_Msk        (1UL << Reg_IRQ_Status_SLICE_Pos)
 
 #define Reg_IRQ_Status_Msk              Reg_IRQ_Status_FRAME_Msk     | \
                                         Reg_IRQ_Status_OVERFLOW_Msk  | \
                                         Reg_IRQ_Status_UNDERFLOW_Msk | \
-                                        Reg_IRQ_Status_EOS_Msk
+                                        Reg_IRQ_Status_EOS_Msk       | \
+                                        Reg_IRQ_Status_SLICE_Msk
 
 // Video peripheral access structure
 static ARM_VSI_Type * const pVideo[4] = { VideoI0, VideoO0, VideoI1, VideoO1 };
@@ -118,6 +129,120 @@ static ARM_VSI_Type * const pVideo[4] = { VideoI0, VideoO0, VideoI1, VideoO1 };
 static uint8_t  Initialized = 0U;
 static uint8_t  Configured[4] = { 0U, 0U, 0U, 0U };
 
+// Frame geometry: frame size in bytes and DMA slices per frame
+static uint32_t FrameSize[4]   = { 0U, 0U, 0U, 0U };
+static uint32_t FrameSlices[4] = { 1U, 1U, 1U, 1U };
+
+// Frame buffer address: input ring or output frame
+static uint32_t BufAddress[4]  = { 0U, 0U, 0U, 0U };
+
+// Input capture: the DMA transfers one frame at a time into the ring slot the driver points
+// it at, and is paused while that slot is still occupied
+static uint32_t          StreamMode[4]    = { 0U, 0U, 0U, 0U };
+static volatile uint32_t DmaSlot[4]       = { 0U, 0U, 0U, 0U };
+static volatile uint8_t  CapturePaused[4] = { 0U, 0U, 0U, 0U };
+static volatile uint64_t PauseTime[4];
+
+// Frame ownership: frames acquired by the application and returned to the input ring.
+// Returned frames are counted by the output interrupt while a frame is lent and by the
+// application otherwise.
+static volatile uint32_t FramesAcquired[4] = { 0U, 0U, 0U, 0U };
+static volatile uint32_t FramesReturned[4] = { 0U, 0U, 0U, 0U };
+// Input channel + 1 of the frame lent to an output channel, 0 if none
+static volatile uint8_t  LentFrom[4] = { 0U, 0U, 0U, 0U };
+
+// Number of input frames held by the application or lent to an output channel
+static uint32_t FramesHeld (uint32_t channel) {
+  return (FramesAcquired[channel] - FramesReturned[channel]);
+}
+
+// Check if a frame of an input channel is lent to an output channel
+static uint32_t FrameLent (uint32_t channel) {
+  uint32_t n;
+
+  for (n = 1U; n < 4U; n += 2U) {
+    if (LentFrom[n] == (channel + 1U)) {
+      return 1U;
+    }
+  }
+  return 0U;
+}
+
+// Capture records per input buffer slot, written from the input interrupt only
+static volatile uint64_t CaptureTime[4][VIDEO_DRV_MAX_FRAMES];
+static volatile uint32_t CaptureSeq [4][VIDEO_DRV_MAX_FRAMES];
+static volatile uint32_t CaptureCount[4] = { 0U, 0U, 0U, 0U };
+
+// Frame being captured in slices: buffer slot and slices received, written from the input
+// interrupt only
+static volatile uint32_t CaptureSlot[4]  = { 0U, 0U, 0U, 0U };
+static volatile uint32_t SlicesDone[4]   = { 0U, 0U, 0U, 0U };
+
+// Input ring position of the next frame to acquire and number of frames available to acquire.
+// Re-read if a lent frame was returned by an output interrupt in between.
+static uint32_t InputFramesAvailable (uint32_t channel, uint32_t *index) {
+  uint32_t held;
+  uint32_t count;
+
+  do {
+    held   = FramesHeld(channel);
+    *index = pVideo[channel]->Reg_FRAME_INDEX;
+    count  = pVideo[channel]->Reg_FRAME_COUNT;
+  } while (held != FramesHeld(channel));
+
+  *index = (*index + held) % pVideo[channel]->Reg_FRAME_COUNT_MAX;
+
+  return ((count > held) ? (count - held) : 0U);
+}
+
+// Point the input DMA at the ring slot of the next frame
+static void CaptureSetSlot (uint32_t channel) {
+  pVideo[channel]->DMA.Control = 0U;
+  pVideo[channel]->DMA.Address = BufAddress[channel] + (DmaSlot[channel] * FrameSize[channel]);
+  pVideo[channel]->DMA.Control = ARM_VSI_DMA_Enable_Msk | ARM_VSI_DMA_Direction_P2M;
+}
+
+// Run the channel timer, periodically in continuous mode
+static void TimerRun (uint32_t channel) {
+  uint32_t control;
+
+  control = ARM_VSI_Timer_Run_Msk      |
+            ARM_VSI_Timer_Trig_DMA_Msk |
+            ARM_VSI_Timer_Trig_IRQ_Msk;
+  if (StreamMode[channel] == VIDEO_DRV_MODE_CONTINUOS) {
+    control |= ARM_VSI_Timer_Periodic_Msk;
+  }
+  pVideo[channel]->Timer.Control = control;
+}
+
+// Resume a paused input capture once a frame was released to the ring.
+// Called from an interrupt handler or with interrupts disabled.
+static void CaptureResume (uint32_t channel) {
+
+  if ((CapturePaused[channel] != 0U) &&
+      ((pVideo[channel]->Reg_STATUS & Reg_STATUS_ACTIVE_Msk) != 0U) &&
+      (pVideo[channel]->Reg_FRAME_COUNT < pVideo[channel]->Reg_FRAME_COUNT_MAX)) {
+    // Frames the source delivered in the meantime are dropped: skip their sequence numbers
+    CaptureCount[channel] += (uint32_t)(((VideoDrv_GetTimestamp() - PauseTime[channel]) *
+                                         pVideo[channel]->Reg_FRAME_RATE) /
+                                        VideoDrv_GetTimestampFreq());
+    CapturePaused[channel] = 0U;
+    CaptureSetSlot(channel);
+    TimerRun(channel);
+  }
+}
+
+// Release the oldest frame of an input ring and resume the capture if it was waiting for it
+static void InputRelease (uint32_t channel) {
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  pVideo[channel]->Reg_FRAME_INDEX = 0U;
+  CaptureResume(channel);
+  __set_PRIMASK(primask);
+}
+
 // Event Callback
 static VideoDrv_Event_t CB_Event = NULL;
 
@@ -131,6 +256,39 @@ static void Video_Handler (uint32_t channel) {
   __DSB();
   __ISB();
 
+  // Input frame slice received: track the frame being filled, in the slot the DMA is
+  // pointed at
+  if (((channel & 1U) == 0U) && ((irq_status & Reg_IRQ_Status_SLICE_Msk) != 0U)) {
+    if (SlicesDone[channel] == 0U) {
+      CaptureSlot[channel] = DmaSlot[channel];
+    }
+    SlicesDone[channel]++;
+  }
+
+  // Input frame captured: record it against the ring slot the DMA was pointed at
+  if (((channel & 1U) == 0U) && ((irq_status & Reg_IRQ_Status_FRAME_Msk) != 0U)) {
+    if (pVideo[channel]->Reg_FRAME_COUNT != 0U) {
+      CaptureTime[channel][DmaSlot[channel]] = VideoDrv_GetTimestamp();
+      CaptureSeq [channel][DmaSlot[channel]] = CaptureCount[channel];
+    }
+    SlicesDone[channel] = 0U;
+    CaptureCount[channel]++;
+
+    // Next frame goes to the following slot. The DMA does not know about the ring state,
+    // so it is stopped rather than let it overwrite the oldest frame when the ring is full,
+    // which includes frames held by the application until they are returned.
+    DmaSlot[channel] = (DmaSlot[channel] + 1U) % pVideo[channel]->Reg_FRAME_COUNT_MAX;
+    if (pVideo[channel]->Reg_FRAME_COUNT >= pVideo[channel]->Reg_FRAME_COUNT_MAX) {
+      pVideo[channel]->Timer.Control = 0U;
+      pVideo[channel]->DMA.Control   = 0U;
+      PauseTime[channel]     = VideoDrv_GetTimestamp();
+      CapturePaused[channel] = 1U;
+      irq_status |= Reg_IRQ_Status_OVERFLOW_Msk;
+    } else {
+      CaptureSetSlot(channel);
+    }
+  }
+
   event = 0U;
   if (irq_status & Reg_IRQ_Status_FRAME_Msk) {
     event |= VIDEO_DRV_EVENT_FRAME;
@@ -144,6 +302,18 @@ static void Video_Handler (uint32_t channel) {
   if (irq_status & Reg_IRQ_Status_EOS_Msk) {
     event |= VIDEO_DRV_EVENT_EOS;
   }
+  if (irq_status & Reg_IRQ_Status_SLICE_Msk) {
+    event |= VIDEO_DRV_EVENT_SLICE;
+  }
+
+  // Output transfer of a lent frame done: return the frame to the input ring
+  if (((event & VIDEO_DRV_EVENT_FRAME) != 0U) && (LentFrom[channel] != 0U)) {
+    uint32_t in_channel = LentFrom[channel] - 1U;
+    pVideo[in_channel]->Reg_FRAME_INDEX = 0U;
+    FramesReturned[in_channel]++;
+    LentFrom[channel] = 0U;
+    CaptureResume(in_channel);
+  }
 
   if (CB_Event != NULL) {
     CB_Event(channel, event);
@@ -187,6 +357,12 @@ int32_t VideoDrv_Initialize (VideoDrv_Event_t cb_event) {
 
   CB_Event = cb_event;
 
+  // Start the system counter and SysTimer 0 used for capture timestamps
+  if (syscounter_armv8_m_cntrl_init(&SYSCOUNTER_CNTRL_ARMV8_M_DEV) != SYSCOUNTER_ARMV8_M_ERR_NONE) {
+    return VIDEO_DRV_ERROR;
+  }
+  systimer_armv8_m_init(&SYSTIMER0_ARMV8_M_DEV);
+
   // Initialize Video Input channel 0
   #if (VIDEO_INPUT_CHANNELS >= 1)
     VideoI0->Timer.Control = 0U;
@@ -386,6 +562,138 @@ int32_t VideoDrv_Configure (uint32_t channel, uint32_t frame_width, uint32_t fra
   pVideo[channel]->Timer.Interval   = 1000000U / frame_rate;
   pVideo[channel]->DMA.BlockSize    = block_size;
 
+  // Whole frames of pixels in the color format
+  pVideo[channel]->Reg_FRAME_SLICES  = 1U;
+  pVideo[channel]->Reg_TENSOR_LAYOUT = VIDEO_DRV_TENSOR_NONE;
+
+  FrameSize[channel]   = block_size;
+  FrameSlices[channel] = 1U;
+
+  Configured[channel] = 1U;
+
+  return VIDEO_DRV_OK;
+}
+
+// Configure Video input channel tensor format
+int32_t VideoDrv_ConfigureTensor (uint32_t channel, const VideoDrv_TensorDesc_t *desc) {
+  uint32_t pixel_size;
+  uint32_t frame_size;
+  uint32_t scale;
+
+  if (((channel & 1U) != 0U) || ((channel >> 1) >= VIDEO_INPUT_CHANNELS) ||
+      (desc == NULL) || !(desc->scale > 0.0f)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  switch (desc->layout) {
+    case VIDEO_DRV_TENSOR_NONE:
+      pixel_size = 0U;
+      break;
+    case VIDEO_DRV_TENSOR_GRAYSCALE:
+      pixel_size = 8U;
+      break;
+    case VIDEO_DRV_TENSOR_RGB:
+      pixel_size = 24U;
+      break;
+    case VIDEO_DRV_TENSOR_NV12:
+      pixel_size = 12U;
+      break;
+    default:
+      return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  if ((Initialized         == 0U) ||
+      (Configured[channel] == 0U)) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  if ((pVideo[channel]->Reg_STATUS & Reg_STATUS_ACTIVE_Msk) != 0U) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  if (pixel_size == 0U) {
+    // Back to pixels in the color format
+    return VideoDrv_Configure(channel,
+                              pVideo[channel]->Reg_FRAME_WIDTH,
+                              pVideo[channel]->Reg_FRAME_HEIGHT,
+                              pVideo[channel]->Reg_COLOR_FORMAT,
+                              pVideo[channel]->Reg_FRAME_RATE);
+  }
+
+  // NV12 subsamples the chroma in both directions
+  if ((desc->layout == VIDEO_DRV_TENSOR_NV12) &&
+      (((pVideo[channel]->Reg_FRAME_WIDTH  & 1U) != 0U) ||
+       ((pVideo[channel]->Reg_FRAME_HEIGHT & 1U) != 0U))) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  frame_size = ((pVideo[channel]->Reg_FRAME_WIDTH * pVideo[channel]->Reg_FRAME_HEIGHT) * pixel_size) / 8U;
+  frame_size = (frame_size + 3U) & ~3U;
+
+  memcpy(&scale, &desc->scale, sizeof(scale));
+
+  pVideo[channel]->Reg_TENSOR_LAYOUT     = desc->layout;
+  pVideo[channel]->Reg_TENSOR_SIGNED     = (desc->is_signed != 0U) ? 1U : 0U;
+  pVideo[channel]->Reg_TENSOR_ZERO_POINT = (uint32_t)desc->zero_point;
+  pVideo[channel]->Reg_TENSOR_SCALE      = scale;
+
+  // Whole frames of the new size; slices and buffer have to be set again
+  pVideo[channel]->Reg_FRAME_SLICES = 1U;
+  pVideo[channel]->Timer.Interval   = 1000000U / pVideo[channel]->Reg_FRAME_RATE;
+  pVideo[channel]->DMA.BlockSize    = frame_size;
+
+  FrameSize[channel]   = frame_size;
+  FrameSlices[channel] = 1U;
+
+  Configured[channel] = 1U;
+
+  return VIDEO_DRV_OK;
+}
+
+// Set Video input channel slices
+int32_t VideoDrv_SetSlices (uint32_t channel, uint32_t slices) {
+  uint32_t color_format;
+  uint32_t slice_size;
+
+  if (((channel & 1U) != 0U) || ((channel >> 1) >= VIDEO_INPUT_CHANNELS) ||
+      (slices == 0U)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  if ((Initialized         == 0U) ||
+      (Configured[channel] == 0U)) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  if ((pVideo[channel]->Reg_STATUS & Reg_STATUS_ACTIVE_Msk) != 0U) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  // Slices must be whole rows of a packed frame and whole DMA words
+  color_format = pVideo[channel]->Reg_COLOR_FORMAT;
+  if ((pVideo[channel]->Reg_TENSOR_LAYOUT == VIDEO_DRV_TENSOR_NONE) &&
+      (color_format != VIDEO_DRV_COLOR_GRAYSCALE8) &&
+      (color_format != VIDEO_DRV_COLOR_RGB888)     &&
+      (color_format != VIDEO_DRV_COLOR_BGR565)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+  if ((pVideo[channel]->Reg_TENSOR_LAYOUT == VIDEO_DRV_TENSOR_NV12) && (slices != 1U)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+  slice_size = FrameSize[channel] / slices;
+  if (((pVideo[channel]->Reg_FRAME_HEIGHT % slices) != 0U) ||
+      ((FrameSize[channel] % slices) != 0U) ||
+      ((slice_size & 3U) != 0U)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  pVideo[channel]->Reg_FRAME_SLICES = slices;
+  pVideo[channel]->Timer.Interval   = 1000000U / (pVideo[channel]->Reg_FRAME_RATE * slices);
+  pVideo[channel]->DMA.BlockSize    = slice_size;
+
+  FrameSlices[channel] = slices;
+
+  // Buffer has to be set again for the new block size
   Configured[channel] = 1U;
 
   return VIDEO_DRV_OK;
@@ -411,15 +719,29 @@ int32_t VideoDrv_SetBuf (uint32_t channel, void *buf, uint32_t buf_size) {
     return VIDEO_DRV_ERROR;
   }
 
-  block_num = buf_size / pVideo[channel]->DMA.BlockSize;
+  block_num = buf_size / FrameSize[channel];
   if (block_num == 0U) {
     return VIDEO_DRV_ERROR;
   }
+  if (((channel & 1U) == 0U) && (block_num > VIDEO_DRV_MAX_FRAMES)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
 
   pVideo[channel]->Reg_FRAME_COUNT_MAX = block_num;
-  pVideo[channel]->DMA.BlockNum        = block_num;
+  if ((channel & 1U) == 0U) {
+    // Input: one frame per DMA run, placed in the ring by the driver
+    pVideo[channel]->DMA.BlockNum = FrameSlices[channel];
+  } else {
+    pVideo[channel]->DMA.BlockNum = block_num * FrameSlices[channel];
+  }
 
   pVideo[channel]->DMA.Address = (uint32_t)buf;
+  BufAddress[channel]          = (uint32_t)buf;
+
+  FramesAcquired[channel] = 0U;
+  FramesReturned[channel] = 0U;
+  CaptureCount[channel]   = 0U;
+  SlicesDone[channel]     = 0U;
 
   Configured[channel] = 2U;
 
@@ -450,6 +772,7 @@ int32_t VideoDrv_FlushBuf (uint32_t channel) {
 // Start Stream on Video Interface
 int32_t VideoDrv_StreamStart (uint32_t channel, uint32_t mode) {
   uint32_t control;
+  uint32_t primask;
 
   if ((((channel & 1U) == 0U) && ((channel >> 1) >= VIDEO_INPUT_CHANNELS))  ||
       (((channel & 1U) != 0U) && ((channel >> 1) >= VIDEO_OUTPUT_CHANNELS)) ||
@@ -476,21 +799,25 @@ int32_t VideoDrv_StreamStart (uint32_t channel, uint32_t mode) {
     return VIDEO_DRV_ERROR;
   }
 
-  control = ARM_VSI_DMA_Enable_Msk;
+  StreamMode[channel] = mode;
+
   if ((channel & 1U) == 0U) {
-    control |= ARM_VSI_DMA_Direction_P2M;
+    // Input: capture into the ring slot after the frames already in the ring, as soon as
+    // there is room for it
+    primask = __get_PRIMASK();
+    __disable_irq();
+    DmaSlot[channel]       = (pVideo[channel]->Reg_FRAME_INDEX + pVideo[channel]->Reg_FRAME_COUNT) %
+                              pVideo[channel]->Reg_FRAME_COUNT_MAX;
+    SlicesDone[channel]    = 0U;
+    PauseTime[channel]     = VideoDrv_GetTimestamp();
+    CapturePaused[channel] = 1U;
+    CaptureResume(channel);
+    __set_PRIMASK(primask);
   } else {
-    control |= ARM_VSI_DMA_Direction_M2P;
-  }
-  pVideo[channel]->DMA.Control = control;
-
-  control = ARM_VSI_Timer_Run_Msk      |
-            ARM_VSI_Timer_Trig_DMA_Msk |
-            ARM_VSI_Timer_Trig_IRQ_Msk;
-  if (mode == VIDEO_DRV_MODE_CONTINUOS) {
-    control |= ARM_VSI_Timer_Periodic_Msk;
+    // Output
+    pVideo[channel]->DMA.Control = ARM_VSI_DMA_Enable_Msk | ARM_VSI_DMA_Direction_M2P;
+    TimerRun(channel);
   }
-  pVideo[channel]->Timer.Control = control;
 
   return VIDEO_DRV_OK;
 }
@@ -515,13 +842,15 @@ int32_t VideoDrv_StreamStop (uint32_t channel) {
   pVideo[channel]->Timer.Control = 0U;
   pVideo[channel]->DMA.Control   = 0U;
   pVideo[channel]->Reg_CONTROL   = 0U;
+  CapturePaused[channel] = 0U;
 
   return VIDEO_DRV_OK;
 }
 
 // Get Video Frame buffer
 void *VideoDrv_GetFrameBuf (uint32_t channel) {
-  void *frame = NULL;
+  void    *frame = NULL;
+  uint32_t index;
 
   if ((((channel & 1U) == 0U) && ((channel >> 1) >= VIDEO_INPUT_CHANNELS))  ||
       (((channel & 1U) != 0U) && ((channel >> 1) >= VIDEO_OUTPUT_CHANNELS))) {
@@ -534,8 +863,8 @@ void *VideoDrv_GetFrameBuf (uint32_t channel) {
   }
 
   if ((pVideo[channel]->Reg_MODE & Reg_MODE_IO_Msk) == Reg_MODE_Input) {
-    // Input
-    if ((pVideo[channel]->Reg_STATUS & Reg_STATUS_BUF_EMPTY_Msk) != 0U) {
+    // Input: skip frames held by the application
+    if (InputFramesAvailable(channel, &index) == 0U) {
       return NULL;
     }
   } else {
@@ -543,13 +872,182 @@ void *VideoDrv_GetFrameBuf (uint32_t channel) {
     if ((pVideo[channel]->Reg_STATUS & Reg_STATUS_BUF_FULL_Msk) != 0U) {
       return NULL;
     }
+    index = pVideo[channel]->Reg_FRAME_INDEX;
   }
 
-  frame = (void *)(pVideo[channel]->DMA.Address + (pVideo[channel]->Reg_FRAME_INDEX * pVideo[channel]->DMA.BlockSize));
+  frame = (void *)(BufAddress[channel] + (index * FrameSize[channel]));
 
   return frame;
 }
 
+// Acquire Video Frame
+void *VideoDrv_AcquireFrame (uint32_t channel) {
+  void *frame;
+
+  if (((channel & 1U) != 0U) || ((channel >> 1) >= VIDEO_INPUT_CHANNELS)) {
+    return NULL;
+  }
+
+  frame = VideoDrv_GetFrameBuf(channel);
+  if (frame != NULL) {
+    FramesAcquired[channel]++;
+  }
+
+  return frame;
+}
+
+// Wait for Video Frame and acquire it
+int32_t VideoDrv_WaitFrame (uint32_t channel, VideoDrv_Frame_t *frame, uint32_t timeout_us) {
+  uint64_t start;
+  uint64_t timeout;
+  uint32_t slot;
+
+  if (((channel & 1U) != 0U) || ((channel >> 1) >= VIDEO_INPUT_CHANNELS) ||
+      (frame == NULL)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  if ((Initialized         == 0U) ||
+      (Configured[channel] <  2U)) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  start   = VideoDrv_GetTimestamp();
+  timeout = ((uint64_t)timeout_us * VideoDrv_GetTimestampFreq()) / 1000000U;
+
+  for (;;) {
+    frame->buf = VideoDrv_AcquireFrame(channel);
+    if (frame->buf != NULL) {
+      slot = ((uint32_t)frame->buf - BufAddress[channel]) / FrameSize[channel];
+      frame->timestamp = CaptureTime[channel][slot];
+      frame->sequence  = CaptureSeq [channel][slot];
+      return VIDEO_DRV_OK;
+    }
+
+    if ((pVideo[channel]->Reg_STATUS & Reg_STATUS_ACTIVE_Msk) == 0U) {
+      return VIDEO_DRV_ERROR;
+    }
+    if ((timeout_us != VIDEO_DRV_WAIT_FOREVER) &&
+        ((VideoDrv_GetTimestamp() - start) >= timeout)) {
+      return VIDEO_DRV_ERROR_TIMEOUT;
+    }
+
+    // Woken up by the next interrupt, the input channel one at the latest
+    __WFE();
+  }
+}
+
+// Wait for slices of the Video Frame being captured
+int32_t VideoDrv_WaitSlices (uint32_t channel, uint32_t slices, VideoDrv_Capture_t *capture, uint32_t timeout_us) {
+  uint64_t start;
+  uint64_t timeout;
+  uint32_t sequence;
+  uint32_t done;
+  uint32_t slot;
+
+  if (((channel & 1U) != 0U) || ((channel >> 1) >= VIDEO_INPUT_CHANNELS) ||
+      (capture == NULL)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  if ((Initialized         == 0U) ||
+      (Configured[channel] <  2U)) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  if ((slices == 0U) || (slices >= FrameSlices[channel])) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  start   = VideoDrv_GetTimestamp();
+  timeout = ((uint64_t)timeout_us * VideoDrv_GetTimestampFreq()) / 1000000U;
+
+  for (;;) {
+    // Consistent snapshot of the capture progress written by the input interrupt
+    do {
+      sequence = CaptureCount[channel];
+      done     = SlicesDone[channel];
+      slot     = CaptureSlot[channel];
+    } while ((sequence != CaptureCount[channel]) || (done != SlicesDone[channel]));
+
+    if (done >= slices) {
+      capture->buf      = (void *)(BufAddress[channel] + (slot * FrameSize[channel]));
+      capture->sequence = sequence;
+      capture->slices   = done;
+      return VIDEO_DRV_OK;
+    }
+
+    if ((pVideo[channel]->Reg_STATUS & Reg_STATUS_ACTIVE_Msk) == 0U) {
+      return VIDEO_DRV_ERROR;
+    }
+    if ((timeout_us != VIDEO_DRV_WAIT_FOREVER) &&
+        ((VideoDrv_GetTimestamp() - start) >= timeout)) {
+      return VIDEO_DRV_ERROR_TIMEOUT;
+    }
+
+    // Woken up by the next interrupt, the input channel one at the latest
+    __WFE();
+  }
+}
+
+// Get current timestamp
+uint64_t VideoDrv_GetTimestamp (void) {
+  return systimer_armv8_m_get_counter_value(&SYSTIMER0_ARMV8_M_DEV);
+}
+
+// Get timestamp frequency
+uint32_t VideoDrv_GetTimestampFreq (void) {
+  return systimer_armv8_m_get_counter_freq(&SYSTIMER0_ARMV8_M_DEV);
+}
+
+// Lend acquired input Video Frame to output channel
+int32_t VideoDrv_LendFrame (uint32_t in_channel, void *frame, uint32_t out_channel) {
+  uint32_t oldest;
+
+  if (((in_channel  & 1U) != 0U) || ((in_channel  >> 1) >= VIDEO_INPUT_CHANNELS)  ||
+      ((out_channel & 1U) == 0U) || ((out_channel >> 1) >= VIDEO_OUTPUT_CHANNELS) ||
+      (frame == NULL)) {
+    return VIDEO_DRV_ERROR_PARAMETER;
+  }
+
+  if ((Initialized             == 0U) ||
+      (Configured[in_channel]  <  2U) ||
+      (Configured[out_channel] == 0U)) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  if ((LentFrom[out_channel] != 0U) ||
+      ((pVideo[out_channel]->Reg_STATUS & Reg_STATUS_ACTIVE_Msk) != 0U)) {
+    return VIDEO_DRV_ERROR_BUSY;
+  }
+
+  // Frames return to the input ring in order, so only the oldest held one can be lent
+  oldest = BufAddress[in_channel] +
+           (pVideo[in_channel]->Reg_FRAME_INDEX * FrameSize[in_channel]);
+  if ((FramesHeld(in_channel) == 0U) || ((uint32_t)frame != oldest)) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  if (FrameSize[out_channel] != FrameSize[in_channel]) {
+    return VIDEO_DRV_ERROR;
+  }
+
+  // Single frame output buffer placed on the input frame
+  if ((Configured[out_channel] < 2U) || (pVideo[out_channel]->Reg_FRAME_COUNT_MAX != 1U)) {
+    pVideo[out_channel]->Reg_FRAME_COUNT_MAX = 1U;
+    pVideo[out_channel]->DMA.BlockNum        = 1U;
+    Configured[out_channel] = 2U;
+  }
+  pVideo[out_channel]->DMA.Address = (uint32_t)frame;
+  BufAddress[out_channel]          = (uint32_t)frame;
+
+  // Mark the output frame as filled
+  LentFrom[out_channel] = (uint8_t)(in_channel + 1U);
+  pVideo[out_channel]->Reg_FRAME_INDEX = 0U;
+
+  return VIDEO_DRV_OK;
+}
+
 // Release Video Frame
 int32_t VideoDrv_ReleaseFrame (uint32_t channel) {
 
@@ -564,19 +1062,28 @@ int32_t VideoDrv_ReleaseFrame (uint32_t channel) {
   }
 
   if ((pVideo[channel]->Reg_MODE & Reg_MODE_IO_Msk) == Reg_MODE_Input) {
-    // Input
+    // Input: release the oldest acquired frame first; once lent, the output channel
+    // returns it instead
+    if (FramesHeld(channel) != 0U) {
+      if (FrameLent(channel) != 0U) {
+        return VIDEO_DRV_ERROR;
+      }
+      InputRelease(channel);
+      FramesReturned[channel]++;
+      return VIDEO_DRV_OK;
+    }
     if ((pVideo[channel]->Reg_STATUS & Reg_STATUS_BUF_EMPTY_Msk) != 0U) {
       return VIDEO_DRV_ERROR;
     }
+    InputRelease(channel);
   } else {
     // Output
     if ((pVideo[channel]->Reg_STATUS & Reg_STATUS_BUF_FULL_Msk) != 0U) {
       return VIDEO_DRV_ERROR;
     }
+    pVideo[channel]->Reg_FRAME_INDEX = 0U;
   }
 
-  pVideo[channel]->Reg_FRAME_INDEX = 0U;
-
   return VIDEO_DRV_OK;
 }
 
@@ -595,6 +1102,12 @@ VideoDrv_Status_t VideoDrv_GetStatus (uint32_t channel) {
     status.overflow  = (status_reg & Reg_STATUS_OVERFLOW_Msk)  >> Reg_STATUS_OVERFLOW_Pos;
     status.underflow = (status_reg & Reg_STATUS_UNDERFLOW_Msk) >> Reg_STATUS_UNDERFLOW_Pos;
     status.eos       = (status_reg & Reg_STATUS_EOS_Msk)       >> Reg_STATUS_EOS_Pos;
+    if (((channel & 1U) == 0U) && (FramesHeld(channel) != 0U)) {
+      // Input: frames held by the application do not count as captured
+      uint32_t index;
+      status.buf_empty = (InputFramesAvailable(channel, &index) == 0U) ? 1U : 0U;
+      status.buf_full  = 0U;
+    }
   }
 
   return status;
@@ -46,16 +46,33 @@ extern "C"
 #define VIDEO_DRV_COLOR_NV21            (6UL)       ///< 24 bit NV12 color format
 #define VIDEO_DRV_COLOR_FORMAT_END      (7UL)       ///< Color format end
 
+/* Video Tensor Layout */
+#define VIDEO_DRV_TENSOR_NONE           (0UL)       ///< Pixels in the configured color format
+#define VIDEO_DRV_TENSOR_GRAYSCALE      (1UL)       ///< HWC tensor, 1 channel
+#define VIDEO_DRV_TENSOR_RGB            (2UL)       ///< HWC tensor, 3 channels (R, G, B)
+#define VIDEO_DRV_TENSOR_NV12           (3UL)       ///< Y plane, then interleaved U, V plane at half resolution
+
 /* Video Event */
 #define VIDEO_DRV_EVENT_FRAME           (1UL << 0)  ///< Video frame received
 #define VIDEO_DRV_EVENT_OVERFLOW        (1UL << 1)  ///< Video buffer overflow
 #define VIDEO_DRV_EVENT_UNDERFLOW       (1UL << 2)  ///< Video buffer underflow
 #define VIDEO_DRV_EVENT_EOS             (1UL << 3)  ///< Video end of stream
+#define VIDEO_DRV_EVENT_SLICE           (1UL << 4)  ///< Video frame slice received
 
 /* Return code */
 #define VIDEO_DRV_OK                    (0)         ///< Operation succeeded
 #define VIDEO_DRV_ERROR                 (-1)        ///< Unspecified error
 #define VIDEO_DRV_ERROR_PARAMETER       (-2)        ///< Parameter error
+#define VIDEO_DRV_ERROR_BUSY            (-3)        ///< Resource busy
+#define VIDEO_DRV_ERROR_TIMEOUT         (-4)        ///< Timeout occurred
+
+/* Wait timeout */
+#define VIDEO_DRV_WAIT_FOREVER          (0xFFFFFFFFUL) ///< Wait without timeout
+
+/* Capture records */
+#ifndef VIDEO_DRV_MAX_FRAMES
+#define VIDEO_DRV_MAX_FRAMES            (8U)        ///< Maximum number of frames in an input buffer
+#endif
 
 /// Video Status
 typedef struct {
@@ -68,6 +85,28 @@ typedef struct {
   uint32_t reserved     : 26;
 } VideoDrv_Status_t;
 
+/// Captured Video Frame
+typedef struct {
+  void    *buf;                         ///< Frame buffer
+  uint64_t timestamp;                   ///< Capture time in \ref VideoDrv_GetTimestamp ticks
+  uint32_t sequence;                    ///< Capture sequence number (gaps are dropped frames)
+} VideoDrv_Frame_t;
+
+/// Video Tensor descriptor
+typedef struct {
+  uint32_t layout;                      ///< Tensor layout
+  uint32_t is_signed;                   ///< Elements are int8 (1) or uint8 (0)
+  int32_t  zero_point;                  ///< Quantization zero point
+  float    scale;                       ///< Quantization scale of pixel value / 255
+} VideoDrv_TensorDesc_t;
+
+/// Video input Frame being captured
+typedef struct {
+  void    *buf;                         ///< Frame buffer being filled
+  uint32_t sequence;                    ///< Capture sequence number of the frame
+  uint32_t slices;                      ///< Number of slices already in the frame buffer
+} VideoDrv_Capture_t;
+
 /// \brief       Video Events callback function type.
 /// \param[in]   channel        channel number
 /// \param[in]   event          events notification mask
@@ -98,6 +137,33 @@ int32_t VideoDrv_SetFile (uint32_t channel, const char *name);
 /// \return      return code
 int32_t VideoDrv_Configure (uint32_t channel, uint32_t frame_width, uint32_t frame_height, uint32_t color_format, uint32_t frame_rate);
 
+/// \brief       Configure Video input channel tensor format.
+/// \details     Frames are delivered already in a model's quantized input format: converted
+///              to the tensor layout and quantized from pixel values p (0 to 255) as
+///              round(p / 255 / scale) + zero_point, saturated to the element type. The
+///              frame size becomes frame_width * frame_height * channels bytes, or
+///              frame_width * frame_height * 3 / 2 bytes for NV12, which needs an even frame
+///              width and height.
+///              Call after \ref VideoDrv_Configure and before \ref VideoDrv_SetSlices and
+///              \ref VideoDrv_SetBuf.
+/// \param[in]   channel        input channel number
+/// \param[in]   desc           pointer to \ref VideoDrv_TensorDesc_t, layout
+///                             \ref VIDEO_DRV_TENSOR_NONE for pixels in the color format
+/// \return      return code
+int32_t VideoDrv_ConfigureTensor (uint32_t channel, const VideoDrv_TensorDesc_t *desc);
+
+/// \brief       Set Video input channel slices.
+/// \details     Delivers each frame in equal horizontal stripes, one DMA transfer and
+///              \ref VIDEO_DRV_EVENT_SLICE per stripe, so that the first rows of a frame can be
+///              processed while the rest is still being transferred. The frame rate is kept.
+///              Call after \ref VideoDrv_Configure and before \ref VideoDrv_SetBuf.
+///              Only packed color formats and tensors other than NV12 are supported and the
+///              frame height must be a multiple of the number of slices.
+/// \param[in]   channel        input channel number
+/// \param[in]   slices         number of slices per frame (1: whole frames)
+/// \return      return code
+int32_t VideoDrv_SetSlices (uint32_t channel, uint32_t slices);
+
 /// \brief       Set Video channel buffer.
 /// \param[in]   channel        channel number
 /// \param[in]   buf            pointer to buffer for video stream
@@ -111,6 +177,11 @@ int32_t VideoDrv_SetBuf (uint32_t channel, void *buf, uint32_t buf_size);
 int32_t VideoDrv_FlushBuf (uint32_t channel);
 
 /// \brief       Start Video channel stream.
+/// \details     An input channel captures into its buffer as a ring of frames. When the
+///              ring is full the capture pauses instead of overwriting the oldest frame,
+///              signalled by \ref VIDEO_DRV_EVENT_OVERFLOW, and resumes with the next free
+///              frame once a frame is released. The frames missed in the meantime show as a
+///              gap in the capture sequence numbers.
 /// \param[in]   channel        channel number
 /// \param[in]   mode           stream mode
 /// \return      return code
@@ -127,10 +198,72 @@ int32_t VideoDrv_StreamStop (uint32_t channel);
 void *VideoDrv_GetFrameBuf (uint32_t channel);
 
 /// \brief       Release Video channel Frame.
+/// \details     On an input channel holding acquired frames, releases the oldest acquired
+///              frame unless it is lent to an output channel.
 /// \param[in]   channel        channel number
 /// \return      return code
 int32_t VideoDrv_ReleaseFrame (uint32_t channel);
 
+/// \brief       Acquire Video input channel Frame.
+/// \details     Takes ownership of the oldest frame not yet acquired. Acquired frames stay
+///              out of the capture ring until they are lent to an output channel and its
+///              transfer completes, or are released. The capture pauses while the ring slot
+///              it would write next is held. Frames must be lent in the order they were
+///              acquired.
+///              \ref VideoDrv_GetFrameBuf and \ref VideoDrv_GetStatus skip acquired frames.
+/// \param[in]   channel        input channel number
+/// \return      pointer to frame buffer, NULL if no frame is available
+void *VideoDrv_AcquireFrame (uint32_t channel);
+
+/// \brief       Lend an acquired input Frame to an output channel.
+/// \details     The output channel transmits the frame straight from the input frame buffer
+///              on the next \ref VideoDrv_StreamStart, without a copy. Once the transfer
+///              completes, the frame is released back to the input capture ring from the
+///              output interrupt. The output channel needs no buffer of its own.
+/// \param[in]   in_channel     input channel number the frame was acquired from
+/// \param[in]   frame          oldest acquired frame of the input channel
+/// \param[in]   out_channel    output channel number
+/// \return      return code, \ref VIDEO_DRV_ERROR_BUSY while the output channel is still
+///              transmitting
+int32_t VideoDrv_LendFrame (uint32_t in_channel, void *frame, uint32_t out_channel);
+
+/// \brief       Wait for a captured Video input Frame and acquire it.
+/// \details     Sleeps with WFE until the input channel interrupt brings in a frame. The
+///              frame is acquired as with \ref VideoDrv_AcquireFrame and returned together
+///              with its capture time, recorded in the input interrupt. The timeout is checked
+///              whenever the core wakes up, so it resolves to the next interrupt.
+///              The input buffer must hold at most \ref VIDEO_DRV_MAX_FRAMES frames.
+/// \param[in]   channel        input channel number
+/// \param[out]  frame          pointer to \ref VideoDrv_Frame_t
+/// \param[in]   timeout_us     timeout in microseconds or \ref VIDEO_DRV_WAIT_FOREVER
+/// \return      return code, \ref VIDEO_DRV_ERROR_TIMEOUT if no frame came in on time,
+///              \ref VIDEO_DRV_ERROR if the stream is stopped and no frame is buffered
+int32_t VideoDrv_WaitFrame (uint32_t channel, VideoDrv_Frame_t *frame, uint32_t timeout_us);
+
+/// \brief       Wait for slices of the Video input Frame being captured.
+/// \details     Sleeps with WFE until the frame currently being captured holds at least the
+///              requested number of slices. The frame is not complete yet: it is acquired
+///              with \ref VideoDrv_WaitFrame once the last slice lands. A returned sequence
+///              number other than the expected one means the capture moved on to a newer
+///              frame in the meantime.
+/// \param[in]   channel        input channel number
+/// \param[in]   slices         number of slices to wait for, 1 to slices per frame - 1
+/// \param[out]  capture        pointer to \ref VideoDrv_Capture_t
+/// \param[in]   timeout_us     timeout in microseconds or \ref VIDEO_DRV_WAIT_FOREVER
+/// \return      return code, \ref VIDEO_DRV_ERROR_TIMEOUT if the slices did not come in on
+///              time, \ref VIDEO_DRV_ERROR if the stream is stopped
+int32_t VideoDrv_WaitSlices (uint32_t channel, uint32_t slices, VideoDrv_Capture_t *capture, uint32_t timeout_us);
+
+/// \brief       Get current timestamp.
+/// \details     Reads the system counter through SysTimer 0, the time base of the capture
+///              timestamps in \ref VideoDrv_Frame_t.
+/// \return      timestamp in ticks of \ref VideoDrv_GetTimestampFreq
+uint64_t VideoDrv_GetTimestamp (void);
+
+/// \brief       Get timestamp frequency.
+/// \return      timestamp ticks per second
+uint32_t VideoDrv_GetTimestampFreq (void);
+
 /// \brief       Get Video channel status.
 /// \param[in]   channel        channel number
 /// \return      \ref VideoDrv_Status_t
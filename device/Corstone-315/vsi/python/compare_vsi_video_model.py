@@ -0,0 +1,145 @@
+# Copyright (c) 2024 Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Check the native VSI video peripheral model against the Python model:
+#   python setup.py build_ext --inplace
+#   python compare_vsi_video_model.py [--steps 200000] [--seed 1]
+# Both models get the same random sequence of hook calls, each with its own fake
+# video client. Return values and client calls must be identical after every call.
+
+import argparse
+import logging
+import os
+import random
+import sys
+
+# The Python model in arm_vsi4 is used when the native one is disabled
+os.environ['VSI_VIDEO_NATIVE'] = '0'
+logging.disable(logging.CRITICAL)
+
+import arm_vsi4 as python_model
+import vsi_video
+import vsi_video_model
+
+
+# Video client recording every call; the results vary so that both outcomes get exercised
+class FakeClient:
+    def __init__(self):
+        self.conn   = 1
+        self.calls  = []
+        self.frames = 0
+
+    def setFilename(self, filename, mode):
+        self.calls.append(('setFilename', filename, mode))
+        return len(filename) % 2 == 0
+
+    def configureStream(self, *args):
+        self.calls.append(('configureStream',) + args)
+        return args[0] != 7
+
+    def enableStream(self, mode):
+        self.calls.append(('enableStream', mode))
+        return True
+
+    def attachRing(self):
+        self.calls.append(('attachRing',))
+
+    def disableStream(self):
+        self.calls.append(('disableStream',))
+        return False
+
+    def readFrame(self):
+        self.frames += 1
+        self.calls.append(('readFrame',))
+        data = bytes((self.frames + i) & 0xFF for i in range(self.frames % 50 + 10))
+        return memoryview(data), self.frames % 7 == 0
+
+    def writeFrame(self, data):
+        self.calls.append(('writeFrame', bytes(data)))
+
+
+# Random hook call, weighted towards valid register values
+def random_call(rng):
+    op = rng.randrange(9)
+    if op == 0:
+        return ('rdRegs', rng.randrange(20))
+    if op == 1:
+        index = rng.choice([0, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 11, 12, 13, 14, 15, 16, 17, 30])
+        value = rng.choice([0, 1, 2, 3, 4, 5, 7, 0x3F800000, 0xFFFFFFFF, rng.randrange(1 << 32)])
+        if index == 1:
+            value = rng.randrange(8)
+        elif index == 3:
+            value = rng.randrange(4)
+        elif index == 4:
+            value = rng.randrange(65, 90)
+        elif index in (12, 13):
+            value = rng.randrange(5)
+        return ('wrRegs', index, value)
+    if op == 2:
+        return ('rdIRQ',)
+    if op == 3:
+        return ('wrIRQ', rng.randrange(32))
+    if op == 4:
+        return ('timerEvent',)
+    if op == 5:
+        return ('rdDataDMA', rng.choice([4, 8, 16, 64]))
+    if op == 6:
+        return ('wrDataDMA', bytearray(rng.randrange(256) for _ in range(8)), 8)
+    if op == 7:
+        return ('wrTimer', rng.randrange(3), rng.randrange(100))
+    return ('wrDMA', rng.randrange(2), rng.randrange(4))
+
+
+def normalize(result):
+    if isinstance(result, bool):
+        return int(result)
+    if isinstance(result, (bytes, bytearray, memoryview)):
+        return bytes(result)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare the native and Python VSI video models")
+    parser.add_argument("--steps", type=int, default=200000, help="Number of hook calls")
+    parser.add_argument("--seed", type=int, default=1, help="Random seed")
+    args = parser.parse_args()
+
+    python_client = FakeClient()
+    native_client = FakeClient()
+    vsi_video.Video = python_client
+    native_model = vsi_video_model.VideoPeripheral(native_client)
+
+    rng = random.Random(args.seed)
+    for step in range(args.steps):
+        call = random_call(rng)
+        python_result = normalize(getattr(python_model, call[0])(*call[1:]))
+        native_result = normalize(getattr(native_model, call[0])(*call[1:]))
+        # Compared as text: a NaN frame rate is not equal to itself
+        if (python_result != native_result or
+                repr(python_client.calls) != repr(native_client.calls)):
+            print(f"Mismatch at step {step}: {call}")
+            print(f"  Python: {python_result!r} {python_client.calls}")
+            print(f"  Native: {native_result!r} {native_client.calls}")
+            return 1
+        python_client.calls.clear()
+        native_client.calls.clear()
+
+    print(f"{args.steps} hook calls match ({python_client.frames} frames read)")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,26 @@
+# Copyright (c) 2024 Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Build the native VSI video peripheral model next to the VSI Python scripts:
+#   python setup.py build_ext --inplace
+# Use the Python version of the FVP (see the FVP documentation).
+
+from setuptools import setup, Extension
+
+setup(
+    name="vsi_video_model",
+    ext_modules=[Extension("vsi_video_model", ["vsi_video_model.cpp"])],
+)
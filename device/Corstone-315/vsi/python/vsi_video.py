@@ -18,11 +18,13 @@
 
 try:
     import time
+    import mmap
     import atexit
+    import struct
     import logging
-    import subprocess
+    import ipaddress
     from multiprocessing.connection import Client, Connection
-    from os import path, getcwd
+    from os import path, getcwd, getpid, environ
     from os import name as os_name
 except ImportError as err:
     print(f"VSI:Video:ImportError: {err}")
@@ -42,6 +44,8 @@ class VideoClient:
         self.FRAME_READ       = 5
         self.FRAME_WRITE      = 6
         self.CLOSE_SERVER     = 7
+        self.RING_ATTACH      = 8
+        self.SET_CHANNEL      = 9
         # Color space
         self.GRAYSCALE8       = 1
         self.RGB888           = 2
@@ -49,11 +53,24 @@ class VideoClient:
         self.YUV420           = 4
         self.NV12             = 5
         self.NV21             = 6
+        # Frame ring slot state
+        self.SLOT_FREE        = 0
+        self.SLOT_FULL        = 1
         # Variables
         self.conn = None
-
-    def connectToServer(self, address, authkey):
-        for _ in range(50):
+        # Shared memory frame ring (mapped when the server runs on this host)
+        self.ring_enabled     = False
+        self.ring             = None
+        self.ring_file        = ""
+        self.ring_slots       = 0
+        self.ring_header_size = 0
+        self.ring_slot_size   = 0
+        self.ring_index       = 0
+
+    def connectToServer(self, address, authkey, attempts=50):
+        for attempt in range(attempts):
+            if attempt > 0:
+                time.sleep(0.01)
             try:
                 self.conn = Client(address, authkey=authkey.encode('utf-8'))
                 if isinstance(self.conn, Connection):
@@ -62,7 +79,10 @@ class VideoClient:
                     self.conn = None
             except Exception:
                 self.conn = None
-            time.sleep(0.01)
+
+    # Channel of this client, in the session of this FVP process
+    def setChannel(self, channel):
+        self.conn.send([self.SET_CHANNEL, channel, getpid()])
 
     def setFilename(self, filename, mode):
         self.conn.send([self.SET_FILENAME, getcwd(), filename, mode])
@@ -70,8 +90,8 @@ class VideoClient:
 
         return filename_valid
 
-    def configureStream(self, frame_width, frame_height, color_format, frame_rate):
-        self.conn.send([self.STREAM_CONFIGURE, frame_width, frame_height, color_format, frame_rate])
+    def configureStream(self, frame_width, frame_height, color_format, frame_rate, tensor):
+        self.conn.send([self.STREAM_CONFIGURE, frame_width, frame_height, color_format, frame_rate, tensor])
         configuration_valid = self.conn.recv()
 
         return configuration_valid
@@ -88,7 +108,49 @@ class VideoClient:
 
         return stream_active
 
+    def attachRing(self):
+        if not self.ring_enabled:
+            return
+
+        self.conn.send([self.RING_ATTACH])
+        ring = self.conn.recv()
+
+        if ring is None:
+            self.detachRing()
+            return
+
+        ring_file, self.ring_slots, self.ring_header_size, self.ring_slot_size = ring
+        if (ring_file != self.ring_file) or (self.ring is None):
+            self.detachRing()
+            try:
+                with open(ring_file, 'r+b') as f:
+                    self.ring = mmap.mmap(f.fileno(), 0)
+                self.ring_file = ring_file
+                logging.info(f"Frame ring attached: {ring_file}")
+            except Exception as e:
+                logging.warning(f"Frame ring not attached, frames sent over connection: {e}")
+        self.ring_index = self.ring_slots - 1
+
+    def detachRing(self):
+        if self.ring is not None:
+            try:
+                self.ring.close()
+            except BufferError:
+                # Frame data still referenced, mapping released with the last reference
+                pass
+            self.ring = None
+        self.ring_file = ""
+
     def readFrame(self):
+        if self.ring is not None:
+            # Frame data in frame ring slot, valid until the slot is reused
+            self.conn.send([self.FRAME_READ, True])
+            slot, size, eos = self.conn.recv()
+            if slot is None:
+                return bytearray(), eos
+            offset = self.ring_header_size + (slot * self.ring_slot_size)
+            return memoryview(self.ring)[offset : offset + size], eos
+
         self.conn.send([self.FRAME_READ])
         data = self.conn.recv_bytes()
         eos  = self.conn.recv()
@@ -96,11 +158,31 @@ class VideoClient:
         return data, eos
 
     def writeFrame(self, data):
+        if self.ring is not None:
+            size = len(data)
+            if size <= self.ring_slot_size:
+                slot = (self.ring_index + 1) % self.ring_slots
+                # Wait (up to 1 second) for the server to write out the previous frame in the slot
+                for _ in range(1000):
+                    if self.ring[slot] == self.SLOT_FREE:
+                        break
+                    time.sleep(0.001)
+                else:
+                    logging.error("Frame ring slot not freed, frame dropped")
+                    return
+                self.ring_index = slot
+                offset = self.ring_header_size + (slot * self.ring_slot_size)
+                self.ring[offset : offset + size] = data
+                self.ring[slot] = self.SLOT_FULL
+                self.conn.send([self.FRAME_WRITE, slot, size])
+                return
+
         self.conn.send([self.FRAME_WRITE])
         self.conn.send_bytes(data)
 
     def closeServer(self):
         try:
+            self.detachRing()
             if isinstance(self.conn, Connection):
                 self.conn.send([self.CLOSE_SERVER])
                 self.conn.close()
@@ -109,7 +191,7 @@ class VideoClient:
 
 
 # User registers
-REG_IDX_MAX               = 12  # Maximum user register index used in VSI
+REG_IDX_MAX               = 17  # Maximum user register index used in VSI
 MODE                      = 0   # Regs[0]  // Mode: 0=Input, 1=Output
 CONTROL                   = 0   # Regs[1]  // Control: enable, flush
 STATUS                    = 0   # Regs[2]  // Status: active, buf_empty, buf_full, overflow, underflow, eos
@@ -123,6 +205,11 @@ FRAME_RATE                = 0   # Regs[9]  // Frame rate
 FRAME_INDEX               = 0   # Regs[10] // Frame index
 FRAME_COUNT               = 0   # Regs[11] // Frame count
 FRAME_COUNT_MAX           = 0   # Regs[12] // Frame count maximum
+FRAME_SLICES              = 0   # Regs[13] // Number of DMA slices per frame (0 or 1: whole frame)
+TENSOR_LAYOUT             = 0   # Regs[14] // Tensor layout: 0=none (color format), 1=grayscale, 2=RGB
+TENSOR_SIGNED             = 0   # Regs[15] // Tensor elements signed
+TENSOR_ZERO_POINT         = 0   # Regs[16] // Tensor zero point
+TENSOR_SCALE              = 0   # Regs[17] // Tensor scale (IEEE 754 single precision)
 
 # MODE register definitions
 MODE_IO_Msk               = 1<<0
@@ -147,11 +234,26 @@ IRQ_Status_FRAME_Msk      = 1<<0
 IRQ_Status_OVERFLOW_Msk   = 1<<1
 IRQ_Status_UNDERFLOW_Msk  = 1<<2
 IRQ_Status_EOS_Msk        = 1<<3
+IRQ_Status_SLICE_Msk      = 1<<4
 
 # Variables
 Video                     = VideoClient()
 Filename                  = ""
 FilenameIdx               = 0
+FrameData                 = bytearray()
+SliceIdx                  = 0
+
+# Native peripheral model (vsi_video_model, built from vsi_video_model.cpp with setup.py).
+# When available, arm_vsi<n>.py uses its register, timer and DMA hooks instead of the Python
+# model below. Set VSI_VIDEO_NATIVE=0 to use the Python model.
+Native                    = None
+if environ.get('VSI_VIDEO_NATIVE', '1') != '0':
+    try:
+        import vsi_video_model
+        Native = vsi_video_model.VideoPeripheral(Video)
+        logging.info("Native peripheral model loaded")
+    except ImportError:
+        pass
 
 
 # Close VSI Video Server on exit
@@ -159,46 +261,100 @@ def cleanup():
     Video.closeServer()
 
 
+# Start VSI Video Server and wait until it accepts connections
+#  @return True when the server has signalled that it is ready
+def startServer(server_path, address, authkey):
+    import subprocess
+
+    if os_name == 'nt':
+        py_cmd = 'python'
+    else:
+        py_cmd = 'python3.9'
+    cmd = [py_cmd, server_path,
+           "--ip", address[0],
+           "--port", str(address[1]),
+           "--authkey", authkey,
+           "--ready"]
+    # Optional cache of converted input frames, reused by later runs on the same file
+    cache_dir = environ.get('VSI_VIDEO_CACHE')
+    if cache_dir:
+        cmd += ["--cache", cache_dir]
+    # Optional persistent server, reused by later FVP runs (not stopped with this process)
+    persistent = environ.get('VSI_VIDEO_PERSISTENT', '0') != '0'
+    if persistent:
+        cmd += ["--persistent"]
+
+    # A persistent server outlives this process: it must not hold on to its console or log pipe
+    output = subprocess.DEVNULL if persistent else None
+    try:
+        server = subprocess.Popen(cmd, stdout=subprocess.PIPE, text=True,
+                                  stdin=output, stderr=output,
+                                  start_new_session=persistent)
+    except OSError as e:
+        logging.error(f"Server not started: {e}")
+        return False
+
+    # Output before the ready line (import errors) is passed through
+    ready = False
+    for line in server.stdout:
+        if line.strip() == 'VSI Video Server ready':
+            ready = True
+            break
+        print(line, end='')
+    server.stdout.close()
+
+    return ready
+
+
 # Client connection to VSI Video Server
-def init(address, authkey):
+#  @param address server address, shared by all channels
+#  @param authkey server authorization key
+#  @param channel channel number within its direction (0: IN0/OUT0, 1: IN1/OUT1)
+def init(address, authkey, channel=0):
     global FILENAME_VALID
 
     base_dir = path.dirname(__file__)
     server_path = path.join(base_dir, 'vsi_video_server.py')
 
-    logging.info("Start video server")
-    if path.isfile(server_path):
-        # Start Video Server
-        if os_name == 'nt':
-            py_cmd = 'python'
-        else:
-            py_cmd = 'python3.9'
-        cmd = f"{py_cmd} {server_path} "\
-              f"--ip {address[0]} "\
-              f"--port {address[1]} "\
-              f"--authkey {authkey}"
-        subprocess.Popen(cmd, shell=True)
-        # Connect to Video Server
-        Video.connectToServer(address, authkey)
+    # Frames are passed in shared memory when the server runs on this host
+    Video.ring_enabled = ipaddress.ip_address(address[0]).is_loopback
+
+    # One server serves all channels: connect to it if another channel or an earlier
+    # FVP run (persistent server) has started it already
+    Video.connectToServer(address, authkey, attempts=1)
+
+    if Video.conn != None:
+        logging.info("Connected to running video server")
+    elif path.isfile(server_path):
+        logging.info("Start video server")
+        if startServer(server_path, address, authkey):
+            Video.connectToServer(address, authkey, attempts=1)
+        if Video.conn == None:
+            # Not started here (e.g. started concurrently by another FVP run): poll for it
+            Video.connectToServer(address, authkey)
         if Video.conn == None:
             logging.error("Server not connected")
 
     else:
         logging.error(f"Server script not found: {server_path}")
 
+    if Video.conn != None:
+        Video.setChannel(channel)
+
     # Register clean-up function
     atexit.register(cleanup)
 
 
 ## Flush Stream buffer
 def flushBuffer():
-    global STATUS, FRAME_INDEX, FRAME_COUNT
+    global STATUS, FRAME_INDEX, FRAME_COUNT, SliceIdx
 
     STATUS |=  STATUS_BUF_EMPTY_Msk
     STATUS &= ~STATUS_BUF_FULL_Msk
 
     FRAME_INDEX = 0
     FRAME_COUNT = 0
+    SliceIdx    = 0
 
 
 ## VSI IRQ Status register
@@ -217,6 +373,12 @@ def wrIRQ(IRQ_Status, value):
 #  @return IRQ_Status return updated register
 def timerEvent(IRQ_Status):
 
+    if FRAME_SLICES > 1:
+        IRQ_Status |= IRQ_Status_SLICE_Msk
+        if SliceIdx != 0:
+            # Frame not complete yet
+            return IRQ_Status
+
     IRQ_Status |= IRQ_Status_FRAME_Msk
 
     if (STATUS & STATUS_OVERFLOW_Msk) != 0:
@@ -236,16 +398,28 @@ def timerEvent(IRQ_Status):
 
 ## Read data from peripheral for DMA P2M transfer (VSI DMA)
 #  @param size size of data to read (in bytes, multiple of 4)
-#  @return data data read (bytearray)
+#  @return data data read (bytearray, or memoryview of the frame ring)
 def rdDataDMA(size):
-    global STATUS, FRAME_COUNT
+    global STATUS, FRAME_COUNT, FrameData, SliceIdx
 
     if (STATUS & STATUS_ACTIVE_Msk) != 0:
 
         if Video.conn != None:
-            data, eos = Video.readFrame()
-            if eos:
-                STATUS |= STATUS_EOS_Msk
+            if FRAME_SLICES > 1:
+                # Sliced frame: read the frame on the first slice, one slice per transfer
+                if SliceIdx == 0:
+                    FrameData, eos = Video.readFrame()
+                    if eos:
+                        STATUS |= STATUS_EOS_Msk
+                data = FrameData[SliceIdx * size:(SliceIdx + 1) * size]
+                SliceIdx += 1
+                if SliceIdx < FRAME_SLICES:
+                    return data
+                SliceIdx = 0
+            else:
+                data, eos = Video.readFrame()
+                if eos:
+                    STATUS |= STATUS_EOS_Msk
             if FRAME_COUNT < FRAME_COUNT_MAX:
                 FRAME_COUNT += 1
             else:
@@ -284,19 +458,21 @@ def wrDataDMA(data, size):
 ## Write CONTROL register (user register)
 #  @param value value to write (32-bit)
 def wrCONTROL(value):
-    global CONTROL, STATUS
+    global CONTROL, STATUS, SliceIdx
 
     if ((value ^ CONTROL) & CONTROL_ENABLE_Msk) != 0:
         STATUS &= ~STATUS_ACTIVE_Msk
+        SliceIdx = 0
         if (value & CONTROL_ENABLE_Msk) != 0:
             logging.info("Start video stream")
             if Video.conn != None:
                 logging.info("Configure video stream")
-                configuration_valid = Video.configureStream(FRAME_WIDTH, FRAME_HEIGHT, COLOR_FORMAT, FRAME_RATE)
+                configuration_valid = Video.configureStream(FRAME_WIDTH, FRAME_HEIGHT, COLOR_FORMAT, FRAME_RATE, tensorDesc())
                 if configuration_valid:
                     logging.info("Enable video stream")
                     server_active = Video.enableStream(MODE)
                     if server_active:
+                        Video.attachRing()
                         STATUS |=   STATUS_ACTIVE_Msk
                         STATUS &= ~(STATUS_OVERFLOW_Msk | STATUS_UNDERFLOW_Msk | STATUS_EOS_Msk)
                     else:
@@ -320,6 +496,18 @@ def wrCONTROL(value):
     CONTROL = value
 
 
+## Tensor descriptor sent to the server
+#  @return tensor (layout, signed, zero point, scale) or None for pixels in the color format
+def tensorDesc():
+    if TENSOR_LAYOUT == 0:
+        return None
+
+    zero_point = TENSOR_ZERO_POINT - (1 << 32) if TENSOR_ZERO_POINT >= (1 << 31) else TENSOR_ZERO_POINT
+    scale      = struct.unpack('<f', struct.pack('<I', TENSOR_SCALE))[0]
+
+    return (TENSOR_LAYOUT, TENSOR_SIGNED != 0, zero_point, scale)
+
+
 ## Read STATUS register (user register)
 # @return status current STATUS User register (32-bit)
 def rdSTATUS():
@@ -426,6 +614,16 @@ def rdRegs(index):
         value = FRAME_COUNT
     elif index == 12:
         value = FRAME_COUNT_MAX
+    elif index == 13:
+        value = FRAME_SLICES
+    elif index == 14:
+        value = TENSOR_LAYOUT
+    elif index == 15:
+        value = TENSOR_SIGNED
+    elif index == 16:
+        value = TENSOR_ZERO_POINT
+    elif index == 17:
+        value = TENSOR_SCALE
 
     return value
 
@@ -435,7 +633,8 @@ def rdRegs(index):
 #  @param value value to write (32-bit)
 #  @return value value written (32-bit)
 def wrRegs(index, value):
-    global MODE, FRAME_WIDTH, FRAME_HEIGHT, COLOR_FORMAT, FRAME_RATE, FRAME_COUNT_MAX
+    global MODE, FRAME_WIDTH, FRAME_HEIGHT, COLOR_FORMAT, FRAME_RATE, FRAME_COUNT_MAX, FRAME_SLICES
+    global TENSOR_LAYOUT, TENSOR_SIGNED, TENSOR_ZERO_POINT, TENSOR_SCALE
 
     if   index == 0:
         MODE = value
@@ -466,5 +665,16 @@ def wrRegs(index, value):
     elif index == 12:
         FRAME_COUNT_MAX = value
         flushBuffer()
+    elif index == 13:
+        FRAME_SLICES = value
+        flushBuffer()
+    elif index == 14:
+        TENSOR_LAYOUT = value
+    elif index == 15:
+        TENSOR_SIGNED = value
+    elif index == 16:
+        TENSOR_ZERO_POINT = value
+    elif index == 17:
+        TENSOR_SCALE = value
 
     return value
@@ -0,0 +1,945 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Native model of the VSI video peripheral for the FVP's Python VSI layer.
+ *
+ * Implements the user register, IRQ, timer and DMA hooks of arm_vsi<n>.py with the same
+ * semantics as vsi_video.py, so polling registers does not run any Python code. Only the
+ * stream control and frame transfers call back into the Python VideoClient (vsi_video.py),
+ * which talks to the video server.
+ *
+ * Build in place with: python setup.py build_ext --inplace
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+
+namespace {
+
+    /* User registers, see video_drv.c */
+    enum : uint32_t {
+        REG_MODE              = 0,
+        REG_CONTROL           = 1,
+        REG_STATUS            = 2,
+        REG_FILENAME_LEN      = 3,
+        REG_FILENAME_CHAR     = 4,
+        REG_FILENAME_VALID    = 5,
+        REG_FRAME_WIDTH       = 6,
+        REG_FRAME_HEIGHT      = 7,
+        REG_COLOR_FORMAT      = 8,
+        REG_FRAME_RATE        = 9,
+        REG_FRAME_INDEX       = 10,
+        REG_FRAME_COUNT       = 11,
+        REG_FRAME_COUNT_MAX   = 12,
+        REG_FRAME_SLICES      = 13,
+        REG_TENSOR_LAYOUT     = 14,
+        REG_TENSOR_SIGNED     = 15,
+        REG_TENSOR_ZERO_POINT = 16,
+        REG_TENSOR_SCALE      = 17,
+        REG_IDX_MAX           = 17, /* Maximum user register index used by the model */
+        REG_COUNT             = 64  /* Number of VSI user registers */
+    };
+
+    /* MODE register definitions */
+    constexpr uint32_t MODE_IO_Msk = 1U << 0;
+    constexpr uint32_t MODE_Input  = 0U << 0;
+
+    /* CONTROL register definitions */
+    constexpr uint32_t CONTROL_ENABLE_Msk    = 1U << 0;
+    constexpr uint32_t CONTROL_CONTINUOS_Msk = 1U << 1;
+    constexpr uint32_t CONTROL_BUF_FLUSH_Msk = 1U << 2;
+
+    /* STATUS register definitions */
+    constexpr uint32_t STATUS_ACTIVE_Msk    = 1U << 0;
+    constexpr uint32_t STATUS_BUF_EMPTY_Msk = 1U << 1;
+    constexpr uint32_t STATUS_BUF_FULL_Msk  = 1U << 2;
+    constexpr uint32_t STATUS_OVERFLOW_Msk  = 1U << 3;
+    constexpr uint32_t STATUS_UNDERFLOW_Msk = 1U << 4;
+    constexpr uint32_t STATUS_EOS_Msk       = 1U << 5;
+
+    /* IRQ Status register definitions */
+    constexpr uint32_t IRQ_Status_FRAME_Msk     = 1U << 0;
+    constexpr uint32_t IRQ_Status_OVERFLOW_Msk  = 1U << 1;
+    constexpr uint32_t IRQ_Status_UNDERFLOW_Msk = 1U << 2;
+    constexpr uint32_t IRQ_Status_EOS_Msk       = 1U << 3;
+    constexpr uint32_t IRQ_Status_SLICE_Msk     = 1U << 4;
+
+    /* Logs a message through the Python logging module. */
+    void Log(const char* level, const char* message)
+    {
+        PyObject* logging = PyImport_ImportModule("logging");
+        if (logging != nullptr) {
+            PyObject* result = PyObject_CallMethod(logging, level, "s", message);
+            Py_XDECREF(result);
+            Py_DECREF(logging);
+        }
+        PyErr_Clear();
+    }
+
+    /**
+     * @brief   State machine of one VSI video peripheral (user registers, IRQ, timer and DMA).
+     *          Methods calling into the video client return false (or nullptr) with the Python
+     *          exception set when the client raised one.
+     */
+    class VideoPeripheral {
+    public:
+        explicit VideoPeripheral(PyObject* client) : m_client(client)
+        {
+            Py_INCREF(client);
+            this->m_filename.reserve(256);
+        }
+
+        ~VideoPeripheral()
+        {
+            Py_XDECREF(this->m_frameData);
+            Py_DECREF(this->m_client);
+        }
+
+        VideoPeripheral(const VideoPeripheral&)            = delete;
+        VideoPeripheral& operator=(const VideoPeripheral&) = delete;
+
+        uint32_t ReadIrq() const
+        {
+            return this->m_irqStatus;
+        }
+
+        /* Writing the IRQ Status register clears the bits written as 0. */
+        uint32_t WriteIrq(uint32_t value)
+        {
+            this->m_irqStatus &= value;
+            return this->m_irqStatus;
+        }
+
+        uint32_t WriteTimer(uint32_t index, uint32_t value)
+        {
+            if (index == 0) {
+                this->m_timerControl = value;
+            } else if (index == 1) {
+                this->m_timerInterval = value;
+            }
+            return value;
+        }
+
+        uint32_t WriteDma(uint32_t index, uint32_t value)
+        {
+            if (index == 0) {
+                this->m_dmaControl = value;
+            }
+            return value;
+        }
+
+        bool TimerEvent()
+        {
+            if (this->m_frameSlices > 1) {
+                this->m_irqStatus |= IRQ_Status_SLICE_Msk;
+                if (this->m_sliceIdx != 0) {
+                    /* Frame not complete yet */
+                    return true;
+                }
+            }
+
+            this->m_irqStatus |= IRQ_Status_FRAME_Msk;
+
+            if ((this->m_status & STATUS_OVERFLOW_Msk) != 0) {
+                this->m_irqStatus |= IRQ_Status_OVERFLOW_Msk;
+            }
+            if ((this->m_status & STATUS_UNDERFLOW_Msk) != 0) {
+                this->m_irqStatus |= IRQ_Status_UNDERFLOW_Msk;
+            }
+            if ((this->m_status & STATUS_EOS_Msk) != 0) {
+                this->m_irqStatus |= IRQ_Status_EOS_Msk;
+            }
+
+            if ((this->m_control & CONTROL_CONTINUOS_Msk) == 0) {
+                return this->WriteControl(this->m_control &
+                                          ~(CONTROL_ENABLE_Msk | CONTROL_CONTINUOS_Msk));
+            }
+            return true;
+        }
+
+        /* Returns a new bytearray of size bytes, zero padded past the frame data. */
+        PyObject* ReadDataDma(uint32_t size)
+        {
+            PyObject* data = PyByteArray_FromStringAndSize(nullptr, size);
+            if (data == nullptr) {
+                return nullptr;
+            }
+            char* dst = PyByteArray_AS_STRING(data);
+            std::memset(dst, 0, size);
+
+            if ((this->m_status & STATUS_ACTIVE_Msk) == 0 || !this->Connected()) {
+                return data;
+            }
+
+            size_t offset = 0;
+            if (this->m_frameSlices > 1) {
+                /* Sliced frame: read the frame on the first slice, one slice per transfer */
+                if (this->m_sliceIdx == 0 && !this->ReadFrame()) {
+                    Py_DECREF(data);
+                    return nullptr;
+                }
+                offset = static_cast<size_t>(this->m_sliceIdx) * size;
+            } else if (!this->ReadFrame()) {
+                Py_DECREF(data);
+                return nullptr;
+            }
+
+            Py_buffer frame;
+            if (PyObject_GetBuffer(this->m_frameData, &frame, PyBUF_SIMPLE) != 0) {
+                Py_DECREF(data);
+                return nullptr;
+            }
+            const size_t frameLen = static_cast<size_t>(frame.len);
+            if (offset < frameLen) {
+                const size_t n = std::min<size_t>(size, frameLen - offset);
+                std::memcpy(dst, static_cast<const char*>(frame.buf) + offset, n);
+            }
+            PyBuffer_Release(&frame);
+
+            if (this->m_frameSlices > 1) {
+                this->m_sliceIdx++;
+                if (this->m_sliceIdx < this->m_frameSlices) {
+                    return data;
+                }
+                this->m_sliceIdx = 0;
+            }
+
+            if (this->m_frameCount < this->m_frameCountMax) {
+                this->m_frameCount++;
+            } else {
+                this->m_status |= STATUS_OVERFLOW_Msk;
+            }
+            if (this->m_frameCount == this->m_frameCountMax) {
+                this->m_status |= STATUS_BUF_FULL_Msk;
+            }
+            this->m_status &= ~STATUS_BUF_EMPTY_Msk;
+
+            return data;
+        }
+
+        bool WriteDataDma(PyObject* data)
+        {
+            if ((this->m_status & STATUS_ACTIVE_Msk) == 0 || !this->Connected()) {
+                return true;
+            }
+
+            PyObject* result = PyObject_CallMethod(this->m_client, "writeFrame", "O", data);
+            if (result == nullptr) {
+                return false;
+            }
+            Py_DECREF(result);
+
+            if (this->m_frameCount > 0) {
+                this->m_frameCount--;
+            } else {
+                this->m_status |= STATUS_UNDERFLOW_Msk;
+            }
+            if (this->m_frameCount == 0) {
+                this->m_status |= STATUS_BUF_EMPTY_Msk;
+            }
+            this->m_status &= ~STATUS_BUF_FULL_Msk;
+
+            return true;
+        }
+
+        uint32_t ReadReg(uint32_t index)
+        {
+            if (index <= REG_IDX_MAX) {
+                this->m_regs[index] = this->ReadModelReg(index);
+            }
+            return this->m_regs[index];
+        }
+
+        bool WriteReg(uint32_t index, uint32_t value, uint32_t& written)
+        {
+            if (index <= REG_IDX_MAX && !this->WriteModelReg(index, value)) {
+                return false;
+            }
+            this->m_regs[index] = value;
+            written             = value;
+            return true;
+        }
+
+    private:
+        bool Connected() const
+        {
+            PyObject* conn = PyObject_GetAttrString(this->m_client, "conn");
+            if (conn == nullptr) {
+                PyErr_Clear();
+                return false;
+            }
+            const bool connected = (conn != Py_None);
+            Py_DECREF(conn);
+            return connected;
+        }
+
+        /* Reads the next frame from the client into m_frameData. */
+        bool ReadFrame()
+        {
+            PyObject* result = PyObject_CallMethod(this->m_client, "readFrame", nullptr);
+            if (result == nullptr) {
+                return false;
+            }
+
+            PyObject* frame = nullptr;
+            PyObject* eos   = nullptr;
+            if (!PyArg_ParseTuple(result, "OO", &frame, &eos)) {
+                Py_DECREF(result);
+                return false;
+            }
+            Py_INCREF(frame);
+            Py_XDECREF(this->m_frameData);
+            this->m_frameData = frame;
+
+            const int isEos = PyObject_IsTrue(eos);
+            Py_DECREF(result);
+            if (isEos < 0) {
+                return false;
+            }
+            if (isEos) {
+                this->m_status |= STATUS_EOS_Msk;
+            }
+            return true;
+        }
+
+        void FlushBuffer()
+        {
+            this->m_status |= STATUS_BUF_EMPTY_Msk;
+            this->m_status &= ~STATUS_BUF_FULL_Msk;
+
+            this->m_frameIndex = 0;
+            this->m_frameCount = 0;
+            this->m_sliceIdx   = 0;
+        }
+
+        /* Tensor descriptor sent to the server: (layout, signed, zero point, scale) or None. */
+        PyObject* TensorDesc() const
+        {
+            if (this->m_tensorLayout == 0) {
+                Py_RETURN_NONE;
+            }
+
+            float scale;
+            std::memcpy(&scale, &this->m_tensorScale, sizeof(scale));
+            return Py_BuildValue("(IOid)",
+                                 this->m_tensorLayout,
+                                 this->m_tensorSigned != 0 ? Py_True : Py_False,
+                                 static_cast<int32_t>(this->m_tensorZeroPoint),
+                                 static_cast<double>(scale));
+        }
+
+        /* Calls a client method returning a flag, result in enabled. */
+        bool CallClient(const char* method, PyObject* args, bool& enabled)
+        {
+            PyObject* callable = PyObject_GetAttrString(this->m_client, method);
+            if (callable == nullptr) {
+                return false;
+            }
+            PyObject* result = PyObject_CallObject(callable, args);
+            Py_DECREF(callable);
+            if (result == nullptr) {
+                return false;
+            }
+            const int flag = PyObject_IsTrue(result);
+            Py_DECREF(result);
+            if (flag < 0) {
+                return false;
+            }
+            enabled = (flag != 0);
+            return true;
+        }
+
+        bool StartStream()
+        {
+            Log("info", "Configure video stream");
+            PyObject* tensor = this->TensorDesc();
+            if (tensor == nullptr) {
+                return false;
+            }
+            PyObject* args = Py_BuildValue("(IIIIN)",
+                                           this->m_frameWidth,
+                                           this->m_frameHeight,
+                                           this->m_colorFormat,
+                                           this->m_frameRate,
+                                           tensor);
+            if (args == nullptr) {
+                return false;
+            }
+            bool valid      = false;
+            const bool done = this->CallClient("configureStream", args, valid);
+            Py_DECREF(args);
+            if (!done) {
+                return false;
+            }
+            if (!valid) {
+                Log("error", "Configure video stream failed");
+                return true;
+            }
+
+            Log("info", "Enable video stream");
+            args = Py_BuildValue("(I)", this->m_mode);
+            if (args == nullptr) {
+                return false;
+            }
+            bool active = false;
+            if (!this->CallClient("enableStream", args, active)) {
+                Py_DECREF(args);
+                return false;
+            }
+            Py_DECREF(args);
+            if (!active) {
+                Log("error", "Enable video stream failed");
+                return true;
+            }
+
+            PyObject* result = PyObject_CallMethod(this->m_client, "attachRing", nullptr);
+            if (result == nullptr) {
+                return false;
+            }
+            Py_DECREF(result);
+
+            this->m_status |= STATUS_ACTIVE_Msk;
+            this->m_status &= ~(STATUS_OVERFLOW_Msk | STATUS_UNDERFLOW_Msk | STATUS_EOS_Msk);
+            return true;
+        }
+
+        bool WriteControl(uint32_t value)
+        {
+            if (((value ^ this->m_control) & CONTROL_ENABLE_Msk) != 0) {
+                this->m_status &= ~STATUS_ACTIVE_Msk;
+                this->m_sliceIdx = 0;
+                if ((value & CONTROL_ENABLE_Msk) != 0) {
+                    Log("info", "Start video stream");
+                    if (!this->Connected()) {
+                        Log("error", "Server not connected");
+                    } else if (!this->StartStream()) {
+                        return false;
+                    }
+                } else {
+                    Log("info", "Stop video stream");
+                    if (!this->Connected()) {
+                        Log("error", "Server not connected");
+                    } else {
+                        Log("info", "Disable video stream");
+                        PyObject* result =
+                            PyObject_CallMethod(this->m_client, "disableStream", nullptr);
+                        if (result == nullptr) {
+                            return false;
+                        }
+                        Py_DECREF(result);
+                    }
+                }
+            }
+
+            if ((value & CONTROL_BUF_FLUSH_Msk) != 0) {
+                value &= ~CONTROL_BUF_FLUSH_Msk;
+                this->FlushBuffer();
+            }
+
+            this->m_control = value;
+            return true;
+        }
+
+        void WriteFilenameLen(uint32_t value)
+        {
+            this->m_filename.clear();
+            this->m_filenameValid = 0;
+            this->m_filenameLen   = value;
+        }
+
+        bool WriteFilenameChar(uint32_t value)
+        {
+            if (this->m_filename.size() < this->m_filenameLen) {
+                this->m_filename.push_back(static_cast<char>(value));
+            }
+
+            if (this->m_filename.size() == this->m_filenameLen) {
+                Log("info", "Check if file exists on Server side and set VALID flag");
+                if (!this->Connected()) {
+                    Log("error", "Server not connected");
+                    return true;
+                }
+                PyObject* args = Py_BuildValue("(s#I)",
+                                               this->m_filename.data(),
+                                               static_cast<Py_ssize_t>(this->m_filename.size()),
+                                               this->m_mode);
+                if (args == nullptr) {
+                    return false;
+                }
+                bool valid      = false;
+                const bool done = this->CallClient("setFilename", args, valid);
+                Py_DECREF(args);
+                if (!done) {
+                    return false;
+                }
+                this->m_filenameValid = valid ? 1 : 0;
+            }
+            return true;
+        }
+
+        uint32_t WriteFrameIndex()
+        {
+            this->m_frameIndex++;
+            if (this->m_frameIndex == this->m_frameCountMax) {
+                this->m_frameIndex = 0;
+            }
+
+            if ((this->m_mode & MODE_IO_Msk) == MODE_Input) {
+                /* Input: frame released */
+                if (this->m_frameCount > 0) {
+                    this->m_frameCount--;
+                }
+                if (this->m_frameCount == 0) {
+                    this->m_status |= STATUS_BUF_EMPTY_Msk;
+                }
+                this->m_status &= ~STATUS_BUF_FULL_Msk;
+            } else {
+                /* Output: frame filled */
+                if (this->m_frameCount < this->m_frameCountMax) {
+                    this->m_frameCount++;
+                }
+                if (this->m_frameCount == this->m_frameCountMax) {
+                    this->m_status |= STATUS_BUF_FULL_Msk;
+                }
+                this->m_status &= ~STATUS_BUF_EMPTY_Msk;
+            }
+
+            return this->m_frameIndex;
+        }
+
+        uint32_t ReadModelReg(uint32_t index)
+        {
+            switch (index) {
+                case REG_MODE:
+                    return this->m_mode;
+                case REG_CONTROL:
+                    return this->m_control;
+                case REG_STATUS: {
+                    /* Reading STATUS clears the sticky flags */
+                    const uint32_t status = this->m_status;
+                    this->m_status &= ~(STATUS_OVERFLOW_Msk | STATUS_UNDERFLOW_Msk | STATUS_EOS_Msk);
+                    return status;
+                }
+                case REG_FILENAME_LEN:
+                    return this->m_filenameLen;
+                case REG_FILENAME_VALID:
+                    return this->m_filenameValid;
+                case REG_FRAME_WIDTH:
+                    return this->m_frameWidth;
+                case REG_FRAME_HEIGHT:
+                    return this->m_frameHeight;
+                case REG_COLOR_FORMAT:
+                    return this->m_colorFormat;
+                case REG_FRAME_RATE:
+                    return this->m_frameRate;
+                case REG_FRAME_INDEX:
+                    return this->m_frameIndex;
+                case REG_FRAME_COUNT:
+                    return this->m_frameCount;
+                case REG_FRAME_COUNT_MAX:
+                    return this->m_frameCountMax;
+                case REG_FRAME_SLICES:
+                    return this->m_frameSlices;
+                case REG_TENSOR_LAYOUT:
+                    return this->m_tensorLayout;
+                case REG_TENSOR_SIGNED:
+                    return this->m_tensorSigned;
+                case REG_TENSOR_ZERO_POINT:
+                    return this->m_tensorZeroPoint;
+                case REG_TENSOR_SCALE:
+                    return this->m_tensorScale;
+                default:
+                    return 0;
+            }
+        }
+
+        /* Writes a model register, value updated to the value the register holds. */
+        bool WriteModelReg(uint32_t index, uint32_t& value)
+        {
+            switch (index) {
+                case REG_MODE:
+                    this->m_mode = value;
+                    break;
+                case REG_CONTROL:
+                    return this->WriteControl(value);
+                case REG_STATUS:
+                    value = this->m_status;
+                    break;
+                case REG_FILENAME_LEN:
+                    this->WriteFilenameLen(value);
+                    break;
+                case REG_FILENAME_CHAR:
+                    return this->WriteFilenameChar(value);
+                case REG_FILENAME_VALID:
+                    value = this->m_filenameValid;
+                    break;
+                case REG_FRAME_WIDTH:
+                    if (value != 0) {
+                        this->m_frameWidth = value;
+                    }
+                    break;
+                case REG_FRAME_HEIGHT:
+                    if (value != 0) {
+                        this->m_frameHeight = value;
+                    }
+                    break;
+                case REG_COLOR_FORMAT:
+                    this->m_colorFormat = value;
+                    break;
+                case REG_FRAME_RATE:
+                    this->m_frameRate = value;
+                    break;
+                case REG_FRAME_INDEX:
+                    value = this->WriteFrameIndex();
+                    break;
+                case REG_FRAME_COUNT:
+                    value = this->m_frameCount;
+                    break;
+                case REG_FRAME_COUNT_MAX:
+                    this->m_frameCountMax = value;
+                    this->FlushBuffer();
+                    break;
+                case REG_FRAME_SLICES:
+                    this->m_frameSlices = value;
+                    this->FlushBuffer();
+                    break;
+                case REG_TENSOR_LAYOUT:
+                    this->m_tensorLayout = value;
+                    break;
+                case REG_TENSOR_SIGNED:
+                    this->m_tensorSigned = value;
+                    break;
+                case REG_TENSOR_ZERO_POINT:
+                    this->m_tensorZeroPoint = value;
+                    break;
+                case REG_TENSOR_SCALE:
+                    this->m_tensorScale = value;
+                    break;
+                default:
+                    break;
+            }
+            return true;
+        }
+
+        PyObject* m_client;              /* VideoClient of vsi_video.py */
+        PyObject* m_frameData = nullptr; /* Frame being delivered in slices */
+
+        /* VSI IRQ, timer and DMA registers */
+        uint32_t m_irqStatus     = 0;
+        uint32_t m_timerControl  = 0;
+        uint32_t m_timerInterval = 0;
+        uint32_t m_dmaControl    = 0;
+
+        /* VSI user registers as last read or written */
+        uint32_t m_regs[REG_COUNT]{};
+
+        /* Video peripheral registers */
+        uint32_t m_mode            = 0;
+        uint32_t m_control         = 0;
+        uint32_t m_status          = 0;
+        uint32_t m_filenameLen     = 0;
+        uint32_t m_filenameValid   = 0;
+        uint32_t m_frameWidth      = 300;
+        uint32_t m_frameHeight     = 300;
+        uint32_t m_colorFormat     = 0;
+        uint32_t m_frameRate       = 0;
+        uint32_t m_frameIndex      = 0;
+        uint32_t m_frameCount      = 0;
+        uint32_t m_frameCountMax   = 0;
+        uint32_t m_frameSlices     = 0;
+        uint32_t m_tensorLayout    = 0;
+        uint32_t m_tensorSigned    = 0;
+        uint32_t m_tensorZeroPoint = 0;
+        uint32_t m_tensorScale     = 0;
+
+        uint32_t m_sliceIdx = 0;  /* Next slice of the frame being delivered */
+        std::string m_filename{}; /* Filename received so far */
+    };
+
+    /* Python object wrapping a VideoPeripheral */
+    struct PeripheralObject {
+        PyObject_HEAD
+        VideoPeripheral* model;
+    };
+
+    /* Converts a Python int to a 32-bit register value (truncated like the VSI registers). */
+    bool ToRegValue(PyObject* obj, uint32_t& value)
+    {
+        const unsigned long v = PyLong_AsUnsignedLongMask(obj);
+        if (v == static_cast<unsigned long>(-1) && PyErr_Occurred()) {
+            return false;
+        }
+        value = static_cast<uint32_t>(v);
+        return true;
+    }
+
+    /* Gets two register arguments (index, value) of a fast call. */
+    bool ToIndexValue(PyObject* const* args, Py_ssize_t nargs, uint32_t& index, uint32_t& value)
+    {
+        if (nargs != 2) {
+            PyErr_SetString(PyExc_TypeError, "expected 2 arguments (index, value)");
+            return false;
+        }
+        return ToRegValue(args[0], index) && ToRegValue(args[1], value);
+    }
+
+    /* Gets the model of an object; raises RuntimeError for one that was never initialized,
+     * e.g. created with VideoPeripheral.__new__() or left by a failed __init__(). */
+    VideoPeripheral* Model(PyObject* self)
+    {
+        VideoPeripheral* model = reinterpret_cast<PeripheralObject*>(self)->model;
+        if (model == nullptr) {
+            PyErr_SetString(PyExc_RuntimeError, "VideoPeripheral is not initialized");
+        }
+        return model;
+    }
+
+    int PeripheralInit(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* keywords[] = {"client", nullptr};
+        PyObject* client              = nullptr;
+        if (!PyArg_ParseTupleAndKeywords(
+                args, kwargs, "O", const_cast<char**>(keywords), &client)) {
+            return -1;
+        }
+
+        auto* obj = reinterpret_cast<PeripheralObject*>(self);
+        delete obj->model;
+        obj->model = new (std::nothrow) VideoPeripheral(client);
+        if (obj->model == nullptr) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        return 0;
+    }
+
+    void PeripheralDealloc(PyObject* self)
+    {
+        /* Instances of a heap type hold a reference to it. */
+        PyTypeObject* type = Py_TYPE(self);
+        delete reinterpret_cast<PeripheralObject*>(self)->model;
+        type->tp_free(self);
+        Py_DECREF(type);
+    }
+
+    PyObject* RdIRQ(PyObject* self, PyObject*)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        return PyLong_FromUnsignedLong(model->ReadIrq());
+    }
+
+    PyObject* WrIRQ(PyObject* self, PyObject* arg)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        uint32_t value;
+        if (!ToRegValue(arg, value)) {
+            return nullptr;
+        }
+        return PyLong_FromUnsignedLong(model->WriteIrq(value));
+    }
+
+    PyObject* WrTimer(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        uint32_t index, value;
+        if (!ToIndexValue(args, nargs, index, value)) {
+            return nullptr;
+        }
+        return PyLong_FromUnsignedLong(model->WriteTimer(index, value));
+    }
+
+    PyObject* TimerEvent(PyObject* self, PyObject*)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        if (!model->TimerEvent()) {
+            return nullptr;
+        }
+        Py_RETURN_NONE;
+    }
+
+    PyObject* WrDMA(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        uint32_t index, value;
+        if (!ToIndexValue(args, nargs, index, value)) {
+            return nullptr;
+        }
+        return PyLong_FromUnsignedLong(model->WriteDma(index, value));
+    }
+
+    PyObject* RdDataDMA(PyObject* self, PyObject* arg)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        uint32_t size;
+        if (!ToRegValue(arg, size)) {
+            return nullptr;
+        }
+        return model->ReadDataDma(size);
+    }
+
+    PyObject* WrDataDMA(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        if (nargs != 2) {
+            PyErr_SetString(PyExc_TypeError, "expected 2 arguments (data, size)");
+            return nullptr;
+        }
+        if (!model->WriteDataDma(args[0])) {
+            return nullptr;
+        }
+        Py_RETURN_NONE;
+    }
+
+    PyObject* RdRegs(PyObject* self, PyObject* arg)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        uint32_t index;
+        if (!ToRegValue(arg, index)) {
+            return nullptr;
+        }
+        if (index >= REG_COUNT) {
+            PyErr_SetString(PyExc_IndexError, "user register index out of range");
+            return nullptr;
+        }
+        return PyLong_FromUnsignedLong(model->ReadReg(index));
+    }
+
+    PyObject* WrRegs(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
+    {
+        VideoPeripheral* model = Model(self);
+        if (model == nullptr) {
+            return nullptr;
+        }
+        uint32_t index, value;
+        if (!ToIndexValue(args, nargs, index, value)) {
+            return nullptr;
+        }
+        if (index >= REG_COUNT) {
+            PyErr_SetString(PyExc_IndexError, "user register index out of range");
+            return nullptr;
+        }
+        uint32_t written = 0;
+        if (!model->WriteReg(index, value, written)) {
+            return nullptr;
+        }
+        return PyLong_FromUnsignedLong(written);
+    }
+
+    PyMethodDef peripheralMethods[] = {
+        {"rdIRQ", RdIRQ, METH_NOARGS, "Read the VSI IRQ Status register."},
+        {"wrIRQ", WrIRQ, METH_O, "Write the VSI IRQ Status register."},
+        {"wrTimer",
+         reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(WrTimer)),
+         METH_FASTCALL,
+         "Write a VSI Timer register (index, value)."},
+        {"timerEvent", TimerEvent, METH_NOARGS, "VSI Timer event."},
+        {"wrDMA",
+         reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(WrDMA)),
+         METH_FASTCALL,
+         "Write a VSI DMA register (index, value)."},
+        {"rdDataDMA", RdDataDMA, METH_O, "Read data for a DMA P2M transfer (size)."},
+        {"wrDataDMA",
+         reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(WrDataDMA)),
+         METH_FASTCALL,
+         "Write data of a DMA M2P transfer (data, size)."},
+        {"rdRegs", RdRegs, METH_O, "Read a VSI user register (index)."},
+        {"wrRegs",
+         reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(WrRegs)),
+         METH_FASTCALL,
+         "Write a VSI user register (index, value)."},
+        {nullptr, nullptr, 0, nullptr}};
+
+    PyType_Slot peripheralSlots[] = {
+        {Py_tp_doc, const_cast<char*>("VSI video peripheral model, VideoPeripheral(client).")},
+        {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+        {Py_tp_init, reinterpret_cast<void*>(PeripheralInit)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(PeripheralDealloc)},
+        {Py_tp_methods, peripheralMethods},
+        {0, nullptr}};
+
+    PyType_Spec peripheralSpec = {"vsi_video_model.VideoPeripheral",
+                                  sizeof(PeripheralObject),
+                                  0,
+                                  Py_TPFLAGS_DEFAULT,
+                                  peripheralSlots};
+
+    PyModuleDef moduleDef = {PyModuleDef_HEAD_INIT,
+                             "vsi_video_model",
+                             "Native VSI video peripheral model.",
+                             -1,
+                             nullptr,
+                             nullptr,
+                             nullptr,
+                             nullptr,
+                             nullptr};
+
+} /* namespace */
+
+PyMODINIT_FUNC PyInit_vsi_video_model()
+{
+    PyObject* module = PyModule_Create(&moduleDef);
+    if (module == nullptr) {
+        return nullptr;
+    }
+
+    /* PyModule_AddObject only takes over the reference on success. */
+    PyObject* peripheralType = PyType_FromSpec(&peripheralSpec);
+    if (peripheralType == nullptr ||
+        PyModule_AddObject(module, "VideoPeripheral", peripheralType) < 0) {
+        Py_XDECREF(peripheralType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    if (PyModule_AddIntConstant(module, "REG_IDX_MAX", REG_IDX_MAX) < 0) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+
+    return module;
+}
@@ -23,9 +23,10 @@ logging.basicConfig(format='Py: VSI4: [%(levelname)s]\t%(message)s', level = ver
 logging.info("Verbosity level is set to " + level[verbosity])
 
 
-# Video Server configuration
+# Video Server configuration (one server for all channels)
 server_address = ('127.0.0.1', 6000)
 server_authkey = 'vsi_video'
+server_channel = 0  # Video Input channel 0
 
 
 # IRQ registers
@@ -61,7 +62,7 @@ Data = bytearray()
 #  @return None
 def init():
     logging.info("Python function init() called")
-    vsi_video.init(server_address, server_authkey)
+    vsi_video.init(server_address, server_authkey, server_channel)
 
 
 ## Read interrupt request (the VSI IRQ Status Register)
@@ -199,5 +200,18 @@ def wrRegs(index, value):
     return value
 
 
+# Native peripheral model hooks (see vsi_video.py), replacing the functions above
+if vsi_video.Native is not None:
+    rdIRQ      = vsi_video.Native.rdIRQ
+    wrIRQ      = vsi_video.Native.wrIRQ
+    wrTimer    = vsi_video.Native.wrTimer
+    timerEvent = vsi_video.Native.timerEvent
+    wrDMA      = vsi_video.Native.wrDMA
+    rdDataDMA  = vsi_video.Native.rdDataDMA
+    wrDataDMA  = vsi_video.Native.wrDataDMA
+    rdRegs     = vsi_video.Native.rdRegs
+    wrRegs     = vsi_video.Native.wrRegs
+
+
 ## @}
 
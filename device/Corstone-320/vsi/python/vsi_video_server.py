@@ -18,13 +18,17 @@
 
 try:
     import argparse
+    import hashlib
     import ipaddress
+    import itertools
     import logging
+    import mmap
     import os
-    from multiprocessing.connection import Listener
-
-    import cv2
-    import numpy as np
+    import queue
+    import struct
+    import tempfile
+    import threading
+    from multiprocessing.connection import Listener, wait
 except ImportError as err:
     print(f"VSI:Video:Server:ImportError: {err}")
 except Exception as e:
@@ -53,8 +57,40 @@ MODE_IO_Msk           = 1<<0
 MODE_Input            = 0<<0
 MODE_Output           = 1<<0
 
-class VideoServer:
-    def __init__(self, address, authkey):
+# Number of input frames decoded ahead of the requests
+prefetch_frames       = 4
+
+# Shared memory frame ring: header with one state byte per slot, followed by the frame slots
+ring_slots            = 2
+ring_header_size      = 64
+ring_dir              = '/dev/shm' if os.path.isdir('/dev/shm') else tempfile.gettempdir()
+SLOT_FREE             = 0
+SLOT_FULL             = 1
+ring_counter          = itertools.count(1)
+
+# Line printed on stdout (--ready) once the server accepts connections
+ready_message         = 'VSI Video Server ready'
+
+# OpenCV and NumPy: imported in the background once the server accepts connections,
+# so that starting the server does not wait for them
+cv2                   = None
+np                    = None
+modules_lock          = threading.Lock()
+
+def load_modules():
+    global cv2, np
+    with modules_lock:
+        if np is None:
+            try:
+                import cv2
+                import numpy as np
+            except ImportError as err:
+                logging.error(f"ImportError: {err}")
+
+# Stream of one video channel (one client connection)
+class VideoChannel:
+    def __init__(self, cache_dir=None, persistent=False):
+        load_modules()
         # Server commands
         self.SET_FILENAME     = 1
         self.STREAM_CONFIGURE = 2
@@ -63,6 +99,8 @@ class VideoServer:
         self.FRAME_READ       = 5
         self.FRAME_WRITE      = 6
         self.CLOSE_SERVER     = 7
+        self.RING_ATTACH      = 8
+        self.SET_CHANNEL      = 9
         # Color space
         self.GRAYSCALE8       = 1
         self.RGB888           = 2
@@ -71,7 +109,9 @@ class VideoServer:
         self.NV12             = 5
         self.NV21             = 6
         # Variables
-        self.listener         = Listener(address, authkey=authkey.encode('utf-8'))
+        self.channel          = 0
+        self.session          = None
+        self.persistent       = persistent
         self.filename         = ""
         self.mode             = None
         self.active           = False
@@ -80,11 +120,34 @@ class VideoServer:
         self.frame_ratio      = 0
         self.frame_drop       = 0
         self.frame_index      = 0
+        self.frame_pos        = 0
         self.eos              = False
+        # Input frame prefetch and cache of converted frames
+        self.prefetch_thread  = None
+        self.prefetch_stop    = threading.Event()
+        self.prefetch_queue   = None
+        self.cache_dir        = cache_dir
+        self.cache_file       = None
+        # Tensor layout
+        self.TENSOR_GRAYSCALE = 1
+        self.TENSOR_RGB       = 2
+        self.TENSOR_NV12      = 3
         # Stream configuration
         self.resolution       = (None, None)
         self.color_format     = None
         self.frame_rate       = None
+        self.tensor           = None
+        # Shared memory frame ring
+        self.ring             = None
+        self.ring_file        = ""
+        self.ring_slot_size   = 0
+        self.ring_index       = 0
+        # Output video: raw frames appended until the video is encoded
+        self.segment          = None
+        self.segment_file     = ""
+        self.segment_output   = ""
+        self.segment_size     = (None, None)
+        self.segment_rate     = None
 
     # Set filename
     def _setFilename(self, base_dir, filename, mode):
@@ -93,6 +156,9 @@ class VideoServer:
         if self.active:
             return filename_valid
 
+        # Previous output video complete
+        self.__encodeVideo()
+
         self.filename    = ""
         self.frame_index = 0
 
@@ -123,13 +189,21 @@ class VideoServer:
         return filename_valid
 
     # Configure video stream
-    def _configureStream(self, frame_width, frame_height, color_format, frame_rate):
+    def _configureStream(self, frame_width, frame_height, color_format, frame_rate, tensor=None):
         if (frame_width == 0 or frame_height == 0 or frame_rate == 0):
             return False
 
+        if tensor is not None:
+            layout, _, _, scale = tensor
+            if layout not in (self.TENSOR_GRAYSCALE, self.TENSOR_RGB, self.TENSOR_NV12) or not scale > 0:
+                return False
+            if layout == self.TENSOR_NV12 and (frame_width % 2 != 0 or frame_height % 2 != 0):
+                return False
+
         self.resolution   = (frame_width, frame_height)
         self.color_format = color_format
         self.frame_rate   = frame_rate
+        self.tensor       = tensor
 
         return True
 
@@ -158,43 +232,35 @@ class VideoServer:
         if self.video:
             if self.mode == MODE_Input:
                 if self.filename == "":
-                    self.stream = cv2.VideoCapture(0)
+                    # Camera of the same number as the input channel
+                    self.stream = cv2.VideoCapture(self.channel)
                     if not self.stream.isOpened():
                         logging.error("Failed to open Camera interface")
                         return
                 else:
-                    self.stream = cv2.VideoCapture(self.filename)
-                    self.stream.set(cv2.CAP_PROP_POS_FRAMES, self.frame_index)
-                    video_fps = self.stream.get(cv2.CAP_PROP_FPS)
-                    if video_fps > self.frame_rate:
-                        self.frame_ratio = video_fps / self.frame_rate
-                        logging.debug(f"Frame ratio: {self.frame_ratio}")
+                    self.cache_file = self.__cacheFile()
+                    if (self.cache_file is not None) and os.path.isfile(self.cache_file):
+                        # Frames replayed from the cache, no decoding needed
+                        logging.info(f"Frames read from cache: {self.cache_file}")
+                    else:
+                        self.stream = cv2.VideoCapture(self.filename)
+                        self.stream.set(cv2.CAP_PROP_POS_FRAMES, self.frame_index)
+                        video_fps = self.stream.get(cv2.CAP_PROP_FPS)
+                        if video_fps > self.frame_rate:
+                            self.frame_ratio = video_fps / self.frame_rate
+                            logging.debug(f"Frame ratio: {self.frame_ratio}")
+                    self.__startPrefetch()
             else:
                 if self.filename != "":
-                    extension = str(self.filename).split('.')[-1].lower()
-                    fourcc = cv2.VideoWriter_fourcc(*f'{video_fourcc[extension]}')
-
-                    if os.path.isfile(self.filename) and (self.frame_index != 0):
-                        tmp_filename = f'{self.filename.rstrip(f".{extension}")}_tmp.{extension}'
-                        os.rename(self.filename, tmp_filename)
-                        cap    = cv2.VideoCapture(tmp_filename)
-                        width  = int(cap.get(cv2.CAP_PROP_FRAME_WIDTH))
-                        height = int(cap.get(cv2.CAP_PROP_FRAME_HEIGHT))
-                        self.resolution = (width, height)
-                        self.frame_rate = cap.get(cv2.CAP_PROP_FPS)
-                        self.stream = cv2.VideoWriter(self.filename, fourcc, self.frame_rate, self.resolution)
-
-                        while cap.isOpened():
-                            ret, frame = cap.read()
-                            if not ret:
-                                cap.release()
-                                os.remove(tmp_filename)
-                                break
-                            self.stream.write(frame)
-                            del frame
-
+                    if self.segment is None:
+                        self.__startSegment()
                     else:
-                        self.stream = cv2.VideoWriter(self.filename, fourcc, self.frame_rate, self.resolution)
+                        # Frames appended to the same video keep its resolution and frame rate
+                        self.resolution = self.segment_size
+                        self.frame_rate = self.segment_rate
+
+        # Largest frame is 3 bytes per pixel (RGB888 or RGB tensor)
+        self.__allocateRing(self.resolution[0] * self.resolution[1] * 3)
 
         self.active = True
         logging.info("Stream enabled")
@@ -202,13 +268,201 @@ class VideoServer:
     # Disable Video Server
     def _disableStream(self):
         self.active = False
-        if self.stream is not None:
+        if self.prefetch_thread is not None:
+            self.__stopPrefetch()
+            # Resume after the last frame delivered, not the last one decoded ahead
+            self.frame_index = self.frame_pos
+        elif self.stream is not None:
             if self.mode == MODE_Input:
                 self.frame_index = self.stream.get(cv2.CAP_PROP_POS_FRAMES)
+        if self.stream is not None:
             self.stream.release()
             self.stream = None
         logging.info("Stream disabled")
 
+    # Start output video: frames are appended raw to a temporary file, so restarting the stream
+    # costs nothing, and encoded once the video is complete (new filename or server stop)
+    def __startSegment(self):
+        try:
+            fd, self.segment_file = tempfile.mkstemp(prefix='vsi_video_', suffix='.raw')
+            self.segment = os.fdopen(fd, 'wb')
+        except Exception as e:
+            logging.error(f"Error in startSegment(): {e}")
+            self.segment      = None
+            self.segment_file = ""
+            return
+        self.segment_output = self.filename
+        self.segment_size   = self.resolution
+        self.segment_rate   = self.frame_rate
+
+    # Encode output video from the raw frames
+    def __encodeVideo(self):
+        if self.segment is None:
+            return
+
+        self.segment.close()
+        self.segment = None
+
+        width, height = self.segment_size
+        frame_size    = width * height * 3
+        extension     = str(self.segment_output).split('.')[-1].lower()
+        fourcc        = cv2.VideoWriter_fourcc(*f'{video_fourcc[extension]}')
+        writer        = cv2.VideoWriter(self.segment_output, fourcc, self.segment_rate, self.segment_size)
+
+        frames = 0
+        try:
+            with open(self.segment_file, 'rb') as f:
+                while True:
+                    data = f.read(frame_size)
+                    if len(data) < frame_size:
+                        break
+                    writer.write(np.frombuffer(data, dtype=np.uint8).reshape((height, width, 3)))
+                    frames += 1
+        except Exception as e:
+            logging.error(f"Error in encodeVideo(): {e}")
+        writer.release()
+        logging.info(f"Video encoded: {self.segment_output} ({frames} frames)")
+
+        try:
+            os.remove(self.segment_file)
+        except Exception:
+            pass
+        self.segment_file = ""
+
+    # Cache file of converted frames for the input file and the stream configuration
+    def __cacheFile(self):
+        if self.cache_dir is None:
+            return None
+
+        try:
+            stat = os.stat(self.filename)
+        except OSError:
+            return None
+
+        key = f"{os.path.abspath(self.filename)}|{stat.st_size}|{stat.st_mtime_ns}|"\
+              f"{self.resolution}|{self.color_format}|{self.tensor}|{self.frame_rate}"
+
+        return os.path.join(self.cache_dir, f"{hashlib.sha1(key.encode('utf-8')).hexdigest()}.frames")
+
+    # Start decoding input frames ahead of the requests
+    def __startPrefetch(self):
+        self.frame_pos       = self.frame_index
+        self.prefetch_queue  = queue.Queue(maxsize=prefetch_frames)
+        self.prefetch_stop.clear()
+        self.prefetch_thread = threading.Thread(target=self.__prefetchFrames, daemon=True)
+        self.prefetch_thread.start()
+
+    # Stop decoding input frames ahead and drop the frames not delivered
+    def __stopPrefetch(self):
+        self.prefetch_stop.set()
+        self.prefetch_thread.join()
+        self.prefetch_thread = None
+        self.prefetch_queue  = None
+
+    # Queue a prefetched frame (data, source position, eos)
+    #  @return False when prefetch was stopped
+    def __queueFrame(self, item):
+        while not self.prefetch_stop.is_set():
+            try:
+                self.prefetch_queue.put(item, timeout=0.1)
+                return True
+            except queue.Full:
+                pass
+
+        return False
+
+    # Prefetch thread: decode frames into the queue, or replay them from the cache
+    #  Each cache record is the source position and size of a frame (2 x uint32) followed by its data.
+    #  Only a clip decoded from its first to its last frame is stored, under its final name.
+    def __prefetchFrames(self):
+        cache     = None
+        cache_tmp = ""
+        pos       = int(self.frame_index)
+
+        try:
+            if self.stream is None:
+                with open(self.cache_file, 'rb') as f:
+                    while True:
+                        header = f.read(8)
+                        if len(header) < 8:
+                            break
+                        pos, size = struct.unpack('<II', header)
+                        if pos <= self.frame_index:
+                            f.seek(size, os.SEEK_CUR)
+                        elif not self.__queueFrame((f.read(size), pos, False)):
+                            return
+                self.__queueFrame((None, pos, True))
+                return
+
+            if (self.cache_file is not None) and (pos == 0):
+                try:
+                    cache_tmp = f"{self.cache_file}.{os.getpid()}.{threading.get_ident()}.tmp"
+                    cache     = open(cache_tmp, 'wb')
+                except Exception as e:
+                    logging.warning(f"Frame cache not written: {e}")
+
+            eos = False
+            while not eos:
+                frame, eos = self.__decodeFrame()
+                pos = int(self.stream.get(cv2.CAP_PROP_POS_FRAMES))
+                if (cache is not None) and (frame is not None):
+                    cache.write(struct.pack('<II', pos, len(frame)))
+                    cache.write(frame)
+                if not self.__queueFrame((frame, pos, eos)):
+                    return
+
+            if cache is not None:
+                cache.close()
+                cache = None
+                os.replace(cache_tmp, self.cache_file)
+                logging.info(f"Frames written to cache: {self.cache_file}")
+
+        except Exception as e:
+            logging.error(f"Error in prefetchFrames(): {e}")
+            self.__queueFrame((None, pos, True))
+
+        finally:
+            if cache is not None:
+                cache.close()
+                os.remove(cache_tmp)
+
+    # Allocate shared memory frame ring with slots of at least slot_size bytes
+    def __allocateRing(self, slot_size):
+        if (self.ring is not None) and (slot_size <= self.ring_slot_size):
+            return
+
+        self.__releaseRing()
+
+        # New file name for each allocation, so a client still mapping the old ring detects the change
+        self.ring_file = os.path.join(ring_dir, f"vsi_video_{os.getpid()}_{next(ring_counter)}.ring")
+        try:
+            with open(self.ring_file, 'w+b') as f:
+                f.truncate(ring_header_size + (ring_slots * slot_size))
+                self.ring = mmap.mmap(f.fileno(), 0)
+            self.ring_slot_size = slot_size
+            self.ring_index     = ring_slots - 1
+            logging.debug(f"Frame ring allocated: {self.ring_file}")
+        except Exception as e:
+            logging.error(f"Error in allocateRing(): {e}")
+            self.__releaseRing()
+
+    # Release shared memory frame ring
+    def __releaseRing(self):
+        if self.ring is not None:
+            self.ring.close()
+            self.ring = None
+        if self.ring_file != "":
+            try:
+                os.remove(self.ring_file)
+            except Exception:
+                pass
+            self.ring_file = ""
+        self.ring_slot_size = 0
+
+    # Offset of a frame ring slot
+    def __ringOffset(self, slot):
+        return ring_header_size + (slot * self.ring_slot_size)
+
     # Resize frame to requested resolution in pixels
     def __resizeFrame(self, frame, resolution):
         frame_h = frame.shape[0]
@@ -293,15 +547,38 @@ class VideoServer:
 
         return frame
 
-    # Read frame from source
-    def _readFrame(self):
-        frame = bytearray()
+    # Convert a BGR frame to the quantized tensor layout of a model input
+    def __quantizeFrame(self, frame, tensor):
+        layout, is_signed, zero_point, scale = tensor
+
+        if layout == self.TENSOR_GRAYSCALE:
+            frame = cv2.cvtColor(frame, cv2.COLOR_BGR2GRAY)
+        elif layout == self.TENSOR_NV12:
+            # I420 holds the Y plane, then the U and V planes; NV12 interleaves U and V
+            y_size = frame.shape[0] * frame.shape[1]
+            c_size = y_size // 4
+            i420   = cv2.cvtColor(frame, cv2.COLOR_BGR2YUV_I420).reshape(-1)
+            frame  = np.empty_like(i420)
+            frame[:y_size]       = i420[:y_size]
+            frame[y_size::2]     = i420[y_size:y_size + c_size]
+            frame[y_size + 1::2] = i420[y_size + c_size:]
+        else:
+            frame = cv2.cvtColor(frame, cv2.COLOR_BGR2RGB)
 
-        if not self.active:
-            return frame
+        # Pixel value p in [0, 255] is the real value p / 255
+        frame = np.round(frame.astype(np.float32) / (255.0 * scale)) + zero_point
+        if is_signed:
+            frame = np.clip(frame, -128, 127).astype(np.int8)
+        else:
+            frame = np.clip(frame, 0, 255).astype(np.uint8)
 
-        if self.eos:
-            return frame
+        return frame
+
+    # Decode next frame from source and convert it to the configured format
+    #  @return frame, eos frame data (bytes, None at end of stream) and end of stream flag
+    def __decodeFrame(self):
+        frame = None
+        eos   = False
 
         if self.video:
             if self.frame_ratio > 1:
@@ -318,20 +595,78 @@ class VideoServer:
             else:
                 _, tmp_frame = self.stream.read()
             if tmp_frame is None:
-                self.eos = True
+                eos = True
                 logging.debug("End of stream.")
         else:
             tmp_frame = cv2.imread(self.filename)
-            self.eos  = True
+            eos       = True
             logging.debug("End of stream.")
 
         if tmp_frame is not None:
             tmp_frame = self.__resizeFrame(tmp_frame, self.resolution)
-            tmp_frame = self.__changeColorSpace(tmp_frame, self.color_format)
-            frame = bytearray(tmp_frame.tobytes())
+            if (self.mode == MODE_Input) and (self.tensor is not None):
+                tmp_frame = self.__quantizeFrame(tmp_frame, self.tensor)
+            else:
+                tmp_frame = self.__changeColorSpace(tmp_frame, self.color_format)
+            frame = np.ascontiguousarray(tmp_frame).tobytes()
+
+        return frame, eos
+
+    # Next frame from the prefetch queue or decoded on request
+    #  @return frame frame data (bytes) or None
+    def __nextFrame(self):
+        if not self.active:
+            return None
+
+        if self.eos:
+            return None
+
+        if self.prefetch_thread is not None:
+            frame, self.frame_pos, eos = self.prefetch_queue.get()
+        else:
+            frame, eos = self.__decodeFrame()
+
+        if eos:
+            self.eos = True
 
         return frame
 
+    # Read frame from source
+    def _readFrame(self):
+        frame = self.__nextFrame()
+        if frame is None:
+            frame = bytearray()
+
+        return frame
+
+    # Read frame from source into the next frame ring slot
+    def _readFrameRing(self):
+        slot = None
+        size = 0
+
+        frame = self.__nextFrame()
+        if (frame is not None) and (self.ring is not None):
+            size = len(frame)
+            if size <= self.ring_slot_size:
+                self.ring_index = (self.ring_index + 1) % ring_slots
+                slot   = self.ring_index
+                offset = self.__ringOffset(slot)
+                self.ring[offset : offset + size] = frame
+            else:
+                logging.error(f"Frame ({size} bytes) exceeds frame ring slot")
+                size = 0
+
+        return slot, size
+
+    # Write frame from a frame ring slot to destination and free the slot
+    def _writeFrameRing(self, slot, size):
+        if (self.ring is None) or (slot >= ring_slots) or (size > self.ring_slot_size):
+            return
+
+        offset = self.__ringOffset(slot)
+        self._writeFrame(self.ring[offset : offset + size])
+        self.ring[slot] = SLOT_FREE
+
     # Write frame to destination
     def _writeFrame(self, frame):
         if not self.active:
@@ -339,84 +674,181 @@ class VideoServer:
 
         try:
             decoded_frame = np.frombuffer(frame, dtype=np.uint8)
-            decoded_frame = decoded_frame.reshape((self.resolution[0], self.resolution[1], 3))
+            decoded_frame = decoded_frame.reshape((self.resolution[1], self.resolution[0], 3))
             bgr_frame = self.__changeColorSpace(decoded_frame, self.RGB888)
 
             if self.filename == "":
-                cv2.imshow(self.filename, bgr_frame)
+                cv2.imshow(self.__windowName(), bgr_frame)
                 cv2.waitKey(10)
             else:
                 if self.video:
-                    self.stream.write(np.uint8(bgr_frame))
+                    if self.segment is not None:
+                        self.segment.write(np.uint8(bgr_frame).tobytes())
                     self.frame_index += 1
                 else:
                     cv2.imwrite(self.filename, bgr_frame)
         except Exception:
             pass
 
-    # Run Video Server
-    def run(self):
-        logging.info("Video server started")
+    # Display window of an output channel
+    def __windowName(self):
+        if self.persistent and (self.session is not None):
+            # Several sessions may show the same output channel
+            return f"Video Output {self.channel} [{self.session}]"
+        return f"Video Output {self.channel}"
 
+    # Handle a command received from the channel client
+    #  @return False when the channel is closed
+    def handle(self, conn):
         try:
-            conn = self.listener.accept()
-            logging.info(f'Connection accepted {self.listener.address}')
-        except Exception:
-            logging.error("Connection not accepted")
-            return
-
-        while True:
-            try:
-                recv = conn.recv()
-            except EOFError:
-                return
-
-            cmd     = recv[0]  # Command
-            payload = recv[1:] # Payload
-
-            if  cmd == self.SET_FILENAME:
-                logging.info("Set filename called")
-                filename_valid = self._setFilename(payload[0], payload[1], payload[2])
-                conn.send(filename_valid)
-
-            elif cmd == self.STREAM_CONFIGURE:
-                logging.info("Stream configure called")
-                configuration_valid = self._configureStream(payload[0], payload[1], payload[2], payload[3])
-                conn.send(configuration_valid)
-
-            elif cmd == self.STREAM_ENABLE:
-                logging.info("Enable stream called")
-                self._enableStream(payload[0])
-                conn.send(self.active)
-
-            elif cmd == self.STREAM_DISABLE:
-                logging.info("Disable stream called")
-                self._disableStream()
-                conn.send(self.active)
+            recv = conn.recv()
+        except EOFError:
+            # Client gone without closing the channel, complete the output anyway
+            return False
 
-            elif cmd == self.FRAME_READ:
-                logging.info("Read frame called")
+        cmd     = recv[0]  # Command
+        payload = recv[1:] # Payload
+
+        if  cmd == self.SET_FILENAME:
+            logging.info("Set filename called")
+            filename_valid = self._setFilename(payload[0], payload[1], payload[2])
+            conn.send(filename_valid)
+
+        elif cmd == self.STREAM_CONFIGURE:
+            logging.info("Stream configure called")
+            configuration_valid = self._configureStream(*payload[0:5])
+            conn.send(configuration_valid)
+
+        elif cmd == self.STREAM_ENABLE:
+            logging.info("Enable stream called")
+            self._enableStream(payload[0])
+            conn.send(self.active)
+
+        elif cmd == self.STREAM_DISABLE:
+            logging.info("Disable stream called")
+            self._disableStream()
+            conn.send(self.active)
+
+        elif cmd == self.FRAME_READ:
+            logging.info("Read frame called")
+            if (len(payload) > 0) and payload[0]:
+                # Frame data in frame ring, only slot and size sent
+                slot, size = self._readFrameRing()
+                conn.send([slot, size, self.eos])
+            else:
                 frame = self._readFrame()
                 conn.send_bytes(frame)
                 conn.send(self.eos)
 
-            elif cmd == self.FRAME_WRITE:
-                logging.info("Write frame called")
+        elif cmd == self.FRAME_WRITE:
+            logging.info("Write frame called")
+            if len(payload) == 2:
+                # Frame data in frame ring slot
+                self._writeFrameRing(payload[0], payload[1])
+            else:
                 frame = conn.recv_bytes()
                 self._writeFrame(frame)
 
-            elif cmd == self.CLOSE_SERVER:
-                logging.info("Close server connection")
-                self.stop()
+        elif cmd == self.RING_ATTACH:
+            logging.info("Attach frame ring called")
+            if self.ring is not None:
+                conn.send([self.ring_file, ring_slots, ring_header_size, self.ring_slot_size])
+            else:
+                conn.send(None)
 
-    # Stop Video Server
-    def stop(self):
+        elif cmd == self.SET_CHANNEL:
+            logging.info(f"Set channel called: {payload[0]}")
+            self.channel = payload[0]
+            if len(payload) > 1:
+                self.session = payload[1]
+                logging.info(f"Session {self.session} channel {self.channel} attached")
+
+        elif cmd == self.CLOSE_SERVER:
+            logging.info("Close channel connection")
+            return False
+
+        return True
+
+    # Close video channel
+    def close(self):
         self._disableStream()
+        self.__encodeVideo()
         if (self.mode == MODE_Output) and (self.filename == ""):
             try:
-                cv2.destroyAllWindows()
+                cv2.destroyWindow(self.__windowName())
             except Exception:
                 pass
+        self.__releaseRing()
+
+
+# Video Server: one process serving the video channels of all VSI instances.
+# A persistent server keeps running after the last channel is closed and serves the
+# channels of later sessions (FVP runs) as well.
+class VideoServer:
+    def __init__(self, address, authkey, cache_dir=None, persistent=False):
+        self.listener   = Listener(address, backlog=16, authkey=authkey.encode('utf-8'))
+        self.cache_dir  = cache_dir
+        self.persistent = persistent
+        self.channels   = {}
+        self.accepted   = queue.Queue()
+        self.stopped    = False
+
+    # Accept thread: connections are passed to the server loop, which serves all channels
+    def __accept(self):
+        while not self.stopped:
+            try:
+                conn = self.listener.accept()
+            except Exception:
+                if not self.stopped:
+                    logging.error("Connection not accepted")
+                continue
+            logging.info(f'Connection accepted {self.listener.address}')
+            self.accepted.put(conn)
+
+    # Run Video Server until the last channel is closed (or until stopped when persistent)
+    def run(self):
+        logging.info("Video server started")
+        threading.Thread(target=self.__accept, daemon=True).start()
+        threading.Thread(target=load_modules, daemon=True).start()
+
+        served = False
+        while True:
+            if len(self.channels) == 0:
+                if served and not self.persistent:
+                    break
+                self.__addChannel(self.accepted.get())
+                served = True
+            while not self.accepted.empty():
+                self.__addChannel(self.accepted.get())
+
+            # A failing channel is closed on its own; the other channels keep being served
+            for conn in wait(list(self.channels), timeout=0.1):
+                try:
+                    open_channel = self.channels[conn].handle(conn)
+                except (EOFError, OSError):
+                    open_channel = False
+                except Exception as e:
+                    logging.error(f"Error in channel, closing it: {e!r}")
+                    open_channel = False
+                if not open_channel:
+                    try:
+                        self.channels.pop(conn).close()
+                    except Exception as e:
+                        logging.error(f"Error in closing channel: {e!r}")
+                    conn.close()
+
+        self.stop()
+
+    def __addChannel(self, conn):
+        self.channels[conn] = VideoChannel(self.cache_dir, self.persistent)
+
+    # Stop Video Server
+    def stop(self):
+        self.stopped = True
+        for conn, channel in self.channels.items():
+            channel.close()
+            conn.close()
+        self.channels = {}
         self.listener.close()
         logging.info("Video server stopped")
 
@@ -443,12 +875,34 @@ def parse_arguments():
     parser_optional.add_argument("--authkey", dest="authkey",  metavar="<Auth Key>",
                                         help=f"Authorization key (default: {default_authkey})",
                                         type=str, default=default_authkey)
+    parser_optional.add_argument("--cache", dest="cache",  metavar="<Directory>",
+                                        help="Cache converted input frames in directory (default: disabled)",
+                                        type=str, default=None)
+    parser_optional.add_argument("--persistent", dest="persistent",
+                                        help="Keep running after the last channel is closed",
+                                        action="store_true")
+    parser_optional.add_argument("--ready", dest="ready",
+                                        help="Print a line on stdout once connections are accepted",
+                                        action="store_true")
 
     return parser.parse_args()
 
 if __name__ == '__main__':
     args = parse_arguments()
-    Server = VideoServer((args.ip, args.port), args.authkey)
+    if args.cache is not None:
+        os.makedirs(args.cache, exist_ok=True)
+    try:
+        Server = VideoServer((args.ip, args.port), args.authkey, args.cache, args.persistent)
+    except OSError as e:
+        # Typically another server (started concurrently) already listens on the address
+        logging.error(f"Server not started: {e}")
+        raise SystemExit(1)
+    if args.ready:
+        # Signal the starting client, then detach stdout from it
+        print(ready_message, flush=True)
+        devnull = os.open(os.devnull, os.O_WRONLY)
+        os.dup2(devnull, 1)
+        os.close(devnull)
     try:
         Server.run()
     except KeyboardInterrupt:
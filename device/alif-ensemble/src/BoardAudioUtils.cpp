@@ -55,6 +55,20 @@ static void set_capture_started(bool val)
     s_cap_state.capStarted = val;
 }
 
+static audio_buf* s_stereoBufferDMA     = NULL;
+
+/* Continuous recording state: the I2S callback chains receives on alternate halves.
+ * Only the callback writes s_halvesFilled. */
+static volatile bool s_continuous       = false;
+static volatile uint32_t s_halvesFilled = 0;
+
+static volatile AudioHalfFilledCallback s_halfFilledCallback = NULL;
+
+static void* get_half(uint32_t half)
+{
+    return (uint8_t*)s_stereoBufferDMA->data + (half % 2) * (s_stereoBufferDMA->n_bytes / 2);
+}
+
 /**
  * @brief Callback routine from the i2s driver.
  *
@@ -64,11 +78,25 @@ static void I2SCallback(uint32_t event)
 {
     if (event & ARM_SAI_EVENT_RECEIVE_COMPLETE) {
         s_cap_state.capCompleted = true;
+
+        if (s_continuous) {
+            /* Re-arm the receiver on the other half straight away; the I2S
+             * FIFO absorbs the samples arriving while we are in here. */
+            const uint32_t filled = s_halvesFilled;
+            const uint32_t halfElements = s_stereoBufferDMA->n_elements / 2;
+            s_i2s_drv->Receive(get_half(filled + 1), halfElements);
+            s_halvesFilled = filled + 1;
+
+            const AudioHalfFilledCallback callback = s_halfFilledCallback;
+            if (callback) {
+                void* half = get_half(filled);
+                SCB_InvalidateDCache_by_Addr(half, s_stereoBufferDMA->n_bytes / 2);
+                callback(half, halfElements);
+            }
+        }
     }
 }
 
-static audio_buf* s_stereoBufferDMA     = NULL;
-
 #if defined(__cplusplus)
 }
 #endif /* C */
@@ -192,6 +220,8 @@ void AudioUtils::StopAudioRecording()
     /* Stop the RX */
     int status = 0;
 
+    s_continuous = false;
+
     // status = s_i2s_drv->Control(ARM_SAI_CONTROL_RX, 0, 0);  // Uncomment to start/stop the mic.
     if (status) {
         printf("I2S Control RX stop status = %d\n", status);
@@ -201,6 +231,30 @@ void AudioUtils::StopAudioRecording()
     this->SetAudioEmpty();
 }
 
+void AudioUtils::StartContinuousRecording()
+{
+    if (!s_stereoBufferDMA) {
+        return;
+    }
+
+    s_halvesFilled = 0;
+    s_continuous   = true;
+
+    set_capture_started(true);
+
+    /* Receive into the first half; the callback chains the following ones. */
+    int32_t status = s_i2s_drv->Receive(get_half(0), s_stereoBufferDMA->n_elements / 2);
+    if (status) {
+        printf("I2S Receive status = %d\n", status);
+        s_continuous = false;
+    }
+}
+
+void AudioUtils::SetHalfFilledCallback(AudioHalfFilledCallback callback)
+{
+    s_halfFilledCallback = callback;
+}
+
 AudioUtils::AudioUtils()
 {}
 
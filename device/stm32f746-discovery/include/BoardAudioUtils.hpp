@@ -35,6 +35,14 @@ extern "C" typedef struct _audio_buf {
     uint32_t n_bytes;    /**< Total number of bytes occupied by this buffer. */
 } audio_buf;
 
+/**
+ * @brief   Callback invoked from the audio interrupt once a half of the buffer has been filled
+ *          in continuous mode.
+ * @param[in]   data        Pointer to the start of the filled half.
+ * @param[in]   nElements   Number of elements in the filled half.
+ */
+typedef void (*AudioHalfFilledCallback)(const void* data, uint32_t nElements);
+
 /**
  * @brief Audio utility class.
  */
@@ -83,6 +91,21 @@ public:
      */
     void StopAudioRecording();
 
+    /**
+     * @brief   Starts recording the audio stream continuously into the buffer provided at
+     *          initialisation. The buffer is used as two ping-pong halves: while one half is
+     *          being filled, the other one is handed to the callback registered with
+     *          SetHalfFilledCallback.
+     */
+    void StartContinuousRecording();
+
+    /**
+     * @brief       Registers a callback to be invoked from interrupt context every time a half
+     *              of the buffer has been filled in continuous mode.
+     * @param[in]   callback    Function to call, nullptr to disable.
+     */
+    void SetHalfFilledCallback(AudioHalfFilledCallback callback);
+
     /**
      * @brief   Gets if the recorded audio is stereo
      */
@@ -30,6 +30,22 @@ typedef enum { BUFFER_EMPTY = 0, BUFFER_HALF_FULL = 1, BUFFER_FULL = 2 } BufferS
 
 static BufferStateTypeDef s_bufferState = BUFFER_EMPTY;
 static audio_buf* s_stereoBufferDMA     = NULL;
+
+static volatile AudioHalfFilledCallback s_halfFilledCallback = NULL;
+
+static void NotifyHalfFilled(uint32_t half)
+{
+    const AudioHalfFilledCallback callback = s_halfFilledCallback;
+    if (callback && s_stereoBufferDMA) {
+        const uint32_t halfElements = s_stereoBufferDMA->n_elements / 2;
+
+        int16_t* data = static_cast<int16_t*>(s_stereoBufferDMA->data) + half * halfElements;
+
+        /* The D-cache may hold stale lines for this half from the previous pass. */
+        SCB_InvalidateDCache_by_Addr(data, s_stereoBufferDMA->n_bytes / 2);
+        callback(data, halfElements);
+    }
+}
 }
 #endif /* C */
 
@@ -37,16 +53,21 @@ static audio_buf* s_stereoBufferDMA     = NULL;
  * The audio recording works with two ping-pong buffers.
  * The data for each window will be tranfered by the DMA, which sends
  * sends an interrupt after the transfer is completed.
+ * The DMA runs in circular mode, so the half transfer interrupt signals
+ * that the first half is ready while the second one is being filled, and
+ * the transfer complete interrupt signals the opposite.
  */
 void BSP_AUDIO_IN_TransferComplete_CallBack(void)
 {
     s_bufferState = BUFFER_FULL;
+    NotifyHalfFilled(1);
     return;
 }
 
 void BSP_AUDIO_IN_HalfTransfer_CallBack(void)
 {
     s_bufferState = BUFFER_HALF_FULL;
+    NotifyHalfFilled(0);
     return;
 }
 
@@ -78,6 +99,22 @@ void AudioUtils::StopAudioRecording()
     }
 }
 
+void AudioUtils::StartContinuousRecording()
+{
+    if (!s_stereoBufferDMA) {
+        return;
+    }
+
+    /* The BSP configures the SAI DMA stream in circular mode, so a single
+     * record request keeps capturing until StopAudioRecording is called. */
+    this->StartAudioRecording();
+}
+
+void AudioUtils::SetHalfFilledCallback(AudioHalfFilledCallback callback)
+{
+    s_halfFilledCallback = callback;
+}
+
 AudioUtils::AudioUtils()
 {
     this->SetSysClock_PLL_HSE_200MHz();
@@ -0,0 +1,122 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_BLOCK_QUEUE_HPP
+#define AUDIO_BLOCK_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   Lock-free single-producer/single-consumer queue of audio blocks.
+     *          Blocks are not copied: the producer (typically an audio capture interrupt)
+     *          queues pointers to blocks it owns, such as the halves of a DMA buffer, with
+     *          Push, and the consumer (the application loop) reads them in place with Front
+     *          and Pop. Keeping the blocks valid until they are read is up to the caller.
+     * @tparam  T           Sample type.
+     * @tparam  NumBlocks   Queue depth in blocks; must be a power of two.
+     */
+    template <typename T, size_t NumBlocks>
+    class AudioBlockQueue {
+        static_assert(NumBlocks > 0 && (NumBlocks & (NumBlocks - 1)) == 0,
+                      "NumBlocks must be a power of two");
+
+    public:
+        AudioBlockQueue() = default;
+
+        /**
+         * @brief       Queues a block. Producer side only.
+         * @param[in]   block   Pointer to the block.
+         * @return      true if the block was queued, false if the queue was full and the
+         *              block was dropped.
+         */
+        bool Push(const T* block)
+        {
+            const uint32_t head = this->m_head.load(std::memory_order_relaxed);
+            const uint32_t tail = this->m_tail.load(std::memory_order_acquire);
+
+            if (head - tail == NumBlocks) {
+                this->m_overrunCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            this->m_blocks[head % NumBlocks] = block;
+            this->m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief   Gets the oldest queued block without removing it. Consumer side only.
+         * @return  Pointer to the block, nullptr if the queue is empty.
+         */
+        const T* Front() const
+        {
+            const uint32_t tail = this->m_tail.load(std::memory_order_relaxed);
+            const uint32_t head = this->m_head.load(std::memory_order_acquire);
+
+            if (head == tail) {
+                return nullptr;
+            }
+            return this->m_blocks[tail % NumBlocks];
+        }
+
+        /**
+         * @brief   Removes the oldest queued block. Consumer side only.
+         */
+        void Pop()
+        {
+            const uint32_t tail = this->m_tail.load(std::memory_order_relaxed);
+            if (this->m_head.load(std::memory_order_acquire) != tail) {
+                this->m_tail.store(tail + 1, std::memory_order_release);
+            }
+        }
+
+        /**
+         * @brief   Gets the number of blocks currently queued.
+         */
+        size_t Size() const
+        {
+            return this->m_head.load(std::memory_order_acquire) -
+                   this->m_tail.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief   Gets the number of blocks dropped because the queue was full.
+         */
+        uint32_t GetOverrunCount() const
+        {
+            return this->m_overrunCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+        const T* m_blocks[NumBlocks]{};
+        std::atomic<uint32_t> m_head{0};         /* Written by the producer only. */
+        std::atomic<uint32_t> m_tail{0};         /* Written by the consumer only. */
+        std::atomic<uint32_t> m_overrunCount{0}; /* Written by the producer only. */
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* AUDIO_BLOCK_QUEUE_HPP */
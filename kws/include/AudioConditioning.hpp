@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_CONDITIONING_HPP
+#define AUDIO_CONDITIONING_HPP
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /** Number of fractional bits of the gain used by the conditioning functions. */
+    constexpr uint32_t ms_gainFracBits = 8;
+
+    /**
+     * @brief   Statistics of the raw (unconditioned) samples of a block, gathered while the
+     *          block is being conditioned.
+     */
+    struct AudioBlockStats {
+        int32_t sum{0};    /**< Sum of all samples. */
+        uint32_t count{0}; /**< Number of samples. */
+        int16_t min{0};    /**< Smallest sample. */
+        int16_t max{0};    /**< Largest sample. */
+    };
+
+    /**
+     * @brief       Conditions captured stereo audio for the network in a single pass: adds the
+     *              offset to each channel, applies the gain with saturation to 16 bits and
+     *              averages both channels into one mono sample. Statistics of the raw input
+     *              are collected on the way.
+     *              Uses MVE on Helium capable CPUs and the DSP extension where available.
+     * @param[in]   stereo    Interleaved stereo samples (left, right, left, right, ...).
+     * @param[out]  mono      Destination for nFrames mono samples.
+     * @param[in]   nFrames   Number of stereo frames to process (at most 32767).
+     * @param[in]   offset    Offset added to every sample before the gain.
+     * @param[in]   gain      Gain with ms_gainFracBits fractional bits, from 1.0 up to
+     *                        but not including 32.0.
+     * @param[out]  stats     Statistics of the raw stereo samples.
+     */
+    void ConditionStereoToMono(const int16_t* stereo,
+                               int16_t* mono,
+                               uint32_t nFrames,
+                               int32_t offset,
+                               int32_t gain,
+                               AudioBlockStats& stats);
+
+    /**
+     * @brief       Same as ConditionStereoToMono for audio captured as mono.
+     * @param[in]   in          Mono samples.
+     * @param[out]  out         Destination for nSamples samples.
+     * @param[in]   nSamples    Number of samples to process (at most 65535).
+     * @param[in]   offset      Offset added to every sample before the gain.
+     * @param[in]   gain        Gain with ms_gainFracBits fractional bits, from 1.0 up to
+     *                          but not including 32.0.
+     * @param[out]  stats       Statistics of the raw samples.
+     */
+    void ConditionMono(const int16_t* in,
+                       int16_t* out,
+                       uint32_t nSamples,
+                       int32_t offset,
+                       int32_t gain,
+                       AudioBlockStats& stats);
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* AUDIO_CONDITIONING_HPP */
@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUTOMATIC_GAIN_CONTROL_HPP
+#define AUTOMATIC_GAIN_CONTROL_HPP
+
+#include "AudioConditioning.hpp"
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   Streaming automatic gain control for captured audio.
+     *          Keeps an exponentially smoothed estimate of the DC offset and of the signal
+     *          span (peak envelope with separate attack and release) from the block
+     *          statistics gathered by the conditioning functions, and derives the offset and
+     *          gain to apply to the next block. Has no platform dependencies so it can be
+     *          exercised on the host with recorded audio.
+     */
+    class AutomaticGainControl {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   targetSpan        Signal span (max - min) to scale the input to. It can
+         *                                be based on the training data set, or close to
+         *                                std::numeric_limits<int16_t>::max()/2.
+         * @param[in]   maxGain           Maximum gain; a bigger gain may amplify noise which
+         *                                can lead to false detections. Limited to below 32.0.
+         * @param[in]   offsetSmoothing   Weight of a new block in the DC offset estimate.
+         * @param[in]   attack            Weight of a new block in the span envelope when the
+         *                                span grows.
+         * @param[in]   release           Weight of a new block in the span envelope when the
+         *                                span shrinks.
+         */
+        explicit AutomaticGainControl(int32_t targetSpan     = 18000,
+                                      float maxGain          = 25.f,
+                                      float offsetSmoothing  = 0.1f,
+                                      float attack           = 0.5f,
+                                      float release          = 0.05f);
+
+        /**
+         * @brief       Updates the estimates with the statistics of a freshly conditioned block.
+         * @param[in]   stats   Statistics of the raw samples of the block.
+         */
+        void Update(const AudioBlockStats& stats);
+
+        /**
+         * @brief   Discards the estimates; the next block re-initialises them.
+         */
+        void Reset();
+
+        /**
+         * @brief   Gets the offset to add to the raw samples of the next block.
+         */
+        int32_t GetOffset() const;
+
+        /**
+         * @brief   Gets the gain to apply to the next block, with ms_gainFracBits
+         *          fractional bits.
+         */
+        int32_t GetGain() const;
+
+    private:
+        float m_targetSpan;
+        float m_maxGain;
+        float m_offsetSmoothing;
+        float m_attack;
+        float m_release;
+
+        bool m_primed{false};      /* Estimates hold at least one block. */
+        float m_dcEstimate{0.f};   /* Smoothed mean of the raw samples. */
+        float m_spanEnvelope{0.f}; /* Smoothed span of the raw samples. */
+
+        int32_t m_offset{0};
+        int32_t m_gain{1 << ms_gainFracBits};
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* AUTOMATIC_GAIN_CONTROL_HPP */
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KEYWORD_DETECTOR_HPP
+#define KEYWORD_DETECTOR_HPP
+
+#include "KwsIndexResult.hpp"
+#include "Labels.hpp"
+
+#include <cstdint>
+
+/* Latency budget for keyword detection in milliseconds; bounds how many strides of
+ * posteriors are averaged before a decision is taken. */
+#ifndef KWS_LATENCY_BUDGET_MS
+#define KWS_LATENCY_BUDGET_MS 1000
+#endif /* KWS_LATENCY_BUDGET_MS */
+
+namespace arm {
+namespace app {
+namespace kws {
+
+    /**
+     * @brief   Keyword detector configuration.
+     */
+    struct DetectorConfig {
+        uint32_t averageWindows{1};     /**< Strides of posteriors averaged per decision. */
+        float triggerThreshold{0.7f};   /**< Averaged posterior that starts a detection. */
+        float releaseThreshold{0.4f};   /**< Averaged posterior below which a detection ends. */
+        float refractorySeconds{1.0f};  /**< Time after a detection in which no other starts. */
+    };
+
+    /**
+     * @brief   Turns the posteriors of consecutive inference windows into keyword events.
+     *          Posteriors are averaged over the last few strides; a keyword is reported once
+     *          when its average crosses the trigger threshold, and cannot be reported again
+     *          until it falls below the release threshold (hysteresis) and the refractory
+     *          period has passed. _silence_ and _unknown_ never trigger.
+     */
+    class KeywordDetector {
+    public:
+        /** Maximum number of strides that can be averaged. */
+        static constexpr uint32_t ms_maxAverageWindows = 8;
+
+        /**
+         * @brief       Constructor.
+         * @param[in]   config   Detector configuration; averageWindows is limited to
+         *                       ms_maxAverageWindows.
+         */
+        explicit KeywordDetector(const DetectorConfig& config = DetectorConfig{});
+
+        /**
+         * @brief       Gets the number of strides to average so that the averaging does not
+         *              exceed a latency budget.
+         * @param[in]   latencyBudgetSeconds   Latency budget.
+         * @param[in]   strideSeconds          Time between consecutive windows.
+         * @return      Number of strides, between 1 and ms_maxAverageWindows.
+         */
+        static uint32_t AverageWindowsForLatency(float latencyBudgetSeconds, float strideSeconds);
+
+        /**
+         * @brief       Feeds the posteriors of the next window.
+         * @param[in]   posteriors        Posterior of each label, indexed like labelTable.
+         * @param[in]   timeStamp         Start of the window in seconds; must not decrease.
+         * @param[in]   inferenceNumber   Index of the window.
+         * @param[out]  event             Detected keyword, written only when returning true.
+         * @return      true if a keyword was detected with this window.
+         */
+        bool Update(const float (&posteriors)[numLabels],
+                    float timeStamp,
+                    uint32_t inferenceNumber,
+                    KwsIndexResult& event);
+
+        /**
+         * @brief   Forgets past posteriors and any detection in progress.
+         */
+        void Reset();
+
+    private:
+        DetectorConfig m_config;
+
+        float m_history[ms_maxAverageWindows][numLabels]{}; /* Ring of recent posteriors. */
+        uint32_t m_historyIdx{0};                           /* Next slot to write. */
+        uint32_t m_historyCount{0};                         /* Posteriors held. */
+
+        uint32_t m_activeLabelIdx{noLabelIdx}; /* Keyword being detected, if any. */
+        float m_refractoryEnd{0.f};            /* Time before which nothing may trigger. */
+        bool m_detectedAny{false};             /* Whether m_refractoryEnd is valid. */
+    };
+
+} /* namespace kws */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* KEYWORD_DETECTOR_HPP */
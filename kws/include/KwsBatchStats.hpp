@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KWS_BATCH_STATS_HPP
+#define KWS_BATCH_STATS_HPP
+
+#include "Labels.hpp"
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace kws {
+
+    /**
+     * @brief   Accumulates throughput and accuracy statistics over a batch of audio clips
+     *          and prints them as one machine-readable report. Per-stage timings are left to
+     *          the StageProfiler.
+     */
+    class KwsBatchStats {
+    public:
+        KwsBatchStats() = default;
+
+        /**
+         * @brief       Counts a processed window.
+         * @param[in]   inferred   false if the window was skipped without running the model.
+         */
+        void AddWindow(bool inferred);
+
+        /**
+         * @brief       Counts a processed clip and its classification.
+         * @param[in]   expectedIdx    Expected label index, negative if unknown.
+         * @param[in]   predictedIdx   Predicted label index.
+         */
+        void AddClip(int32_t expectedIdx, uint32_t predictedIdx);
+
+        /**
+         * @brief       Prints the report, delimited by BEGIN/END marker lines.
+         * @param[in]   ticksPerSecond   Tick frequency used to derive throughput.
+         * @param[in]   totalTicks       Ticks spent processing all the windows.
+         */
+        void Print(uint32_t ticksPerSecond, uint64_t totalTicks) const;
+
+    private:
+        uint32_t m_windows{0};
+        uint32_t m_inferences{0};
+        uint32_t m_clips{0};
+        uint32_t m_labelledClips{0};
+        uint32_t m_correctClips{0};
+        uint32_t m_confusion[numLabels][numLabels]{}; /* [expected][predicted] */
+    };
+
+} /* namespace kws */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* KWS_BATCH_STATS_HPP */
@@ -0,0 +1,122 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KWS_INDEX_RESULT_HPP
+#define KWS_INDEX_RESULT_HPP
+
+#include "Labels.hpp"
+#include "TensorFlowLiteMicro.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace arm {
+namespace app {
+namespace kws {
+
+    /** Label index of a window whose top score is below the threshold. */
+    constexpr uint32_t noLabelIdx = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief   Top-1 result of one inference window, referring to its label by index so that
+     *          producing and storing results needs no heap allocations.
+     */
+    struct KwsIndexResult {
+        float timeStamp{0.f};          /**< Start of the window in seconds. */
+        uint32_t inferenceNumber{0};   /**< Index of the window. */
+        uint32_t labelIdx{noLabelIdx}; /**< Index into labelTable, or noLabelIdx. */
+        float score{0.f};              /**< Softmax score of the label. */
+    };
+
+    /**
+     * @brief       Gets the posteriors of a classification output tensor by applying softmax.
+     *              Works directly on the quantised output without intermediate buffers.
+     * @param[in]   outputTensor   Output tensor of the model (int8 or float32).
+     * @param[out]  posteriors     Posterior of each label, indexed like labelTable.
+     * @return      true if successful, false otherwise.
+     */
+    bool GetPosteriors(TfLiteTensor* outputTensor, float (&posteriors)[numLabels]);
+
+    /**
+     * @brief       Gets the top-1 label of a set of posteriors.
+     * @param[in]   posteriors       Posterior of each label, indexed like labelTable.
+     * @param[in]   scoreThreshold   Minimum score for a label to be reported.
+     * @param[out]  result           Label index and score; the label index is noLabelIdx if
+     *                               the top score is below scoreThreshold.
+     */
+    void GetTopResult(const float (&posteriors)[numLabels],
+                      float scoreThreshold,
+                      KwsIndexResult& result);
+
+    /**
+     * @brief   Fixed-capacity ring of results. Once full, pushing a result drops the oldest.
+     * @tparam  Capacity   Maximum number of results held.
+     */
+    template <size_t Capacity>
+    class KwsResultRing {
+        static_assert(Capacity > 0, "Capacity must not be zero");
+
+    public:
+        /**
+         * @brief       Appends a result, dropping the oldest one if the ring is full.
+         * @param[in]   result   Result to append.
+         */
+        void Push(const KwsIndexResult& result)
+        {
+            this->m_results[(this->m_first + this->m_size) % Capacity] = result;
+            if (this->m_size < Capacity) {
+                ++this->m_size;
+            } else {
+                this->m_first = (this->m_first + 1) % Capacity;
+            }
+        }
+
+        /**
+         * @brief       Gets a result, oldest first.
+         * @param[in]   i   Position of the result, below Size().
+         */
+        const KwsIndexResult& operator[](size_t i) const
+        {
+            return this->m_results[(this->m_first + i) % Capacity];
+        }
+
+        /** @brief Gets the number of results held. */
+        size_t Size() const
+        {
+            return this->m_size;
+        }
+
+        /** @brief Drops all results. */
+        void Clear()
+        {
+            this->m_first = 0;
+            this->m_size  = 0;
+        }
+
+    private:
+        KwsIndexResult m_results[Capacity]{};
+        size_t m_first{0};
+        size_t m_size{0};
+    };
+
+} /* namespace kws */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* KWS_INDEX_RESULT_HPP */
@@ -19,14 +19,56 @@
 #ifndef LABELS_HPP
 #define LABELS_HPP
 
-#include <string>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
-/**
- * @brief       Gets the label vector corresponding to the model
- * @param[out]  labels   Vector of strings.
- * @return      true if successful, false otherwise.
- */
-extern bool GetLabelsVector(std::vector<std::string>& labels);
+namespace arm {
+namespace app {
+namespace kws {
+
+    /** Labels of the model, indexed by position in the output tensor. */
+    inline constexpr const char* labelTable[] = {
+        "down",
+        "go",
+        "left",
+        "no",
+        "off",
+        "on",
+        "right",
+        "stop",
+        "up",
+        "yes",
+        "_silence_",
+        "_unknown_",
+    };
+
+    /** Number of labels of the model. */
+    inline constexpr uint32_t numLabels = sizeof(labelTable) / sizeof(labelTable[0]);
+
+    /**
+     * @brief       Gets the index of a label at compile time.
+     * @param[in]   label   Label to look up.
+     * @return      Index of the label, numLabels if it is not in the table.
+     */
+    constexpr uint32_t GetLabelIndex(std::string_view label)
+    {
+        for (uint32_t i = 0; i < numLabels; ++i) {
+            if (label == labelTable[i]) {
+                return i;
+            }
+        }
+        return numLabels;
+    }
+
+    /** Index of the label for windows without speech. */
+    inline constexpr uint32_t silenceLabelIdx = GetLabelIndex("_silence_");
+
+    /** Index of the label for speech that is none of the keywords. */
+    inline constexpr uint32_t unknownLabelIdx = GetLabelIndex("_unknown_");
+
+} /* namespace kws */
+} /* namespace app */
+} /* namespace arm */
 
 #endif /* LABELS_HPP */
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RUNTIME_AUDIO_CLIPS_HPP
+#define RUNTIME_AUDIO_CLIPS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   Layout of a set of audio clips placed in memory at run time, e.g. loaded into
+     *          the runtime_ifm region by the FVP. All fields are little-endian and the blob is
+     *          produced by kws/scripts/pack_audio_clips.py:
+     *
+     *          RuntimeClipsHeader
+     *          RuntimeClipEntry[clipCount]
+     *          16-bit PCM samples of every clip, at the offsets given by the entries.
+     */
+    struct RuntimeClipsHeader {
+        uint32_t magic;      /**< ms_runtimeClipsMagic. */
+        uint32_t version;    /**< ms_runtimeClipsVersion. */
+        uint32_t sampleRate; /**< Sampling rate of all clips in Hz. */
+        uint32_t clipCount;  /**< Number of entries following the header. */
+    };
+
+    /**
+     * @brief   Description of one clip of the blob.
+     */
+    struct RuntimeClipEntry {
+        uint32_t dataOffset;  /**< Offset of the samples from the start of the blob. */
+        uint32_t sampleCount; /**< Number of mono samples. */
+        int32_t labelIdx;     /**< Expected label index, negative if unknown. */
+        uint32_t reserved;    /**< Must be zero. */
+    };
+
+    /** "KWSA" */
+    constexpr uint32_t ms_runtimeClipsMagic   = 0x4153574B;
+    constexpr uint32_t ms_runtimeClipsVersion = 1;
+
+    /**
+     * @brief   Read-only view over audio clips placed in memory at run time. Clips are used
+     *          in place, without copying.
+     */
+    class RuntimeAudioClips {
+    public:
+        RuntimeAudioClips() = default;
+
+        /**
+         * @brief       Validates the blob in a memory region and takes it into use.
+         * @param[in]   region       Start of the memory region.
+         * @param[in]   regionSize   Size of the memory region in bytes.
+         * @return      true if the region holds a valid blob with at least one clip,
+         *              false otherwise.
+         */
+        bool Init(const void* region, size_t regionSize);
+
+        /** @brief Gets the number of clips, 0 if not initialised. */
+        uint32_t GetClipCount() const;
+
+        /** @brief Gets the sampling rate of the clips in Hz. */
+        uint32_t GetSampleRate() const;
+
+        /**
+         * @brief       Gets the samples of a clip.
+         * @param[in]   idx   Clip index.
+         * @return      Pointer to the samples, nullptr if idx is out of range.
+         */
+        const int16_t* GetClip(uint32_t idx) const;
+
+        /**
+         * @brief       Gets the number of samples of a clip.
+         * @param[in]   idx   Clip index.
+         * @return      Number of samples, 0 if idx is out of range.
+         */
+        uint32_t GetClipSize(uint32_t idx) const;
+
+        /**
+         * @brief       Gets the expected label of a clip.
+         * @param[in]   idx   Clip index.
+         * @return      Label index, negative if unknown or idx is out of range.
+         */
+        int32_t GetClipLabel(uint32_t idx) const;
+
+    private:
+        const uint8_t* m_base{nullptr};
+        const RuntimeClipEntry* m_entries{nullptr};
+        uint32_t m_clipCount{0};
+        uint32_t m_sampleRate{0};
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* RUNTIME_AUDIO_CLIPS_HPP */
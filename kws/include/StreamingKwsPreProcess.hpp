@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STREAMING_KWS_PRE_PROCESS_HPP
+#define STREAMING_KWS_PRE_PROCESS_HPP
+
+#include "MicroNetKwsMfcc.hpp"
+#include "TensorFlowLiteMicro.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Pre-processing for a window that slides over live audio by a whole number of
+     *          MFCC strides at a time. The quantized features of each MFCC window are kept in
+     *          a ring, so only the windows completed by the newest audio are computed.
+     *          The ring is separate from the input tensor, whose memory the inference may
+     *          reuse.
+     */
+    class StreamingKwsPreProcess {
+    public:
+        /**
+         * @param[in]   inputTensor       Model input tensor, int8.
+         * @param[in]   numFeatures       Number of MFCC features per window.
+         * @param[in]   numFeatureFrames  Number of MFCC windows in the model input.
+         * @param[in]   mfccFrameLength   MFCC window length in samples.
+         * @param[in]   mfccFrameStride   MFCC window stride in samples.
+         */
+        StreamingKwsPreProcess(TfLiteTensor* inputTensor,
+                               size_t numFeatures,
+                               size_t numFeatureFrames,
+                               uint32_t mfccFrameLength,
+                               uint32_t mfccFrameStride);
+
+        /**
+         * @brief       Computes the features of the MFCC windows ending in the newest samples
+         *              of the audio window; the features of the rest are taken over from the
+         *              previous call. The first call computes all of them.
+         * @param[in]   window       Audio window of m_audioDataWindowSize samples.
+         * @param[in]   newSamples   Samples appended since the previous call, a multiple of
+         *                           the MFCC stride.
+         * @return      true if successful, false otherwise.
+         */
+        bool Update(const int16_t* window, size_t newSamples);
+
+        /** @brief  Writes the features of the current window to the input tensor. */
+        bool CopyToInput();
+
+        size_t m_audioDataWindowSize; /* Amount of audio needed for 1 inference. */
+
+    private:
+        TfLiteTensor* m_inputTensor;
+        size_t m_numFeatures;
+        size_t m_numFeatureFrames;
+        uint32_t m_mfccFrameLength;
+        uint32_t m_mfccFrameStride;
+        QuantParams m_quantParams;
+        audio::MicroNetKwsMFCC m_mfcc;
+        std::vector<int16_t> m_frameAudio;  /* Audio of one MFCC window. */
+        std::vector<int8_t> m_features;     /* Feature ring, one row per MFCC window. */
+        size_t m_oldestRow{0};              /* Ring row of the oldest window. */
+        bool m_primed{false};               /* Whether the ring holds a full window. */
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* STREAMING_KWS_PRE_PROCESS_HPP */
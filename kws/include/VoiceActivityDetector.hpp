@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VOICE_ACTIVITY_DETECTOR_HPP
+#define VOICE_ACTIVITY_DETECTOR_HPP
+
+#include <cstdint>
+
+/* Set to 0 to run the network on every window regardless of voice activity, as the examples
+ * did before the detector was added (see the README). */
+#ifndef KWS_VAD_ENABLED
+#define KWS_VAD_ENABLED 1
+#endif /* KWS_VAD_ENABLED */
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   Voice activity detector configuration. The defaults suit 16 kHz audio
+     *          normalised to roughly half of the 16-bit range.
+     */
+    struct VadConfig {
+        uint32_t frameLength{320};      /**< Samples per analysis frame (20 ms at 16 kHz). */
+        int32_t energyThreshold{1000};  /**< RMS above which a frame is active. */
+        uint32_t zcrThreshold{100};     /**< Zero crossings per frame above which a frame with
+                                             at least half of energyThreshold RMS is active
+                                             (unvoiced speech such as fricatives). */
+        uint32_t minActiveFrames{3};    /**< Active frames needed for an active window. */
+        uint32_t hangoverWindows{1};    /**< Windows kept active after an active one, so
+                                             the tail of an utterance is still classified. */
+    };
+
+    /**
+     * @brief   Frame energy and zero-crossing rate based voice activity detector, used to
+     *          skip feature extraction and inference on windows holding only silence.
+     */
+    class VoiceActivityDetector {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   config   Detector configuration.
+         */
+        explicit VoiceActivityDetector(const VadConfig& config = VadConfig{});
+
+        /**
+         * @brief       Checks a window for voice activity and updates the hangover state.
+         *              Windows are expected in order.
+         * @param[in]   window     Pointer to the q15 samples of the window.
+         * @param[in]   nSamples   Number of samples in the window.
+         * @return      true if the window should be classified, false if it is silence.
+         */
+        bool IsActive(const int16_t* window, uint32_t nSamples);
+
+        /**
+         * @brief   Clears the hangover state, e.g. before a new audio clip.
+         */
+        void Reset();
+
+    private:
+        /* Whether a single frame holds voice activity. */
+        bool IsFrameActive(const int16_t* frame, uint32_t nSamples) const;
+
+        VadConfig m_config;
+        int64_t m_energyThreshold;    /* Sum of squares over a frame for energyThreshold RMS. */
+        uint32_t m_hangoverLeft{0};   /* Windows still to be reported active. */
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* VOICE_ACTIVITY_DETECTOR_HPP */
@@ -0,0 +1,89 @@
+#  SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+#  affiliates <open-source-office@arm.com>
+#  SPDX-License-Identifier: Apache-2.0
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+
+"""
+Packs WAV files into the binary blob read by the keyword spotting wav example from the
+runtime_ifm region (see kws/include/RuntimeAudioClips.hpp). The blob is loaded by the FVP at
+launch, for example:
+
+    FVP_Corstone_SSE-300_Ethos-U55 -a kws.axf --data clips.bin@0x92000000
+
+WAV files must be 16-bit mono. The expected label of a clip is taken from the name of the
+directory holding it (Speech Commands dataset layout), if it is one of the model labels.
+"""
+
+import argparse
+import pathlib
+import struct
+import sys
+import wave
+
+MAGIC = 0x4153574B  # "KWSA"
+VERSION = 1
+HEADER = struct.Struct("<4I")
+ENTRY = struct.Struct("<IIiI")
+MAX_SIZE = 0x01000000  # Size of the runtime_ifm region.
+
+LABELS = ["down", "go", "left", "no", "off", "on", "right", "stop", "up", "yes",
+          "_silence_", "_unknown_"]
+
+
+def read_wav(path, sample_rate):
+    with wave.open(str(path), "rb") as wav:
+        if wav.getnchannels() != 1 or wav.getsampwidth() != 2:
+            sys.exit(f"{path}: expected 16-bit mono audio")
+        if wav.getframerate() != sample_rate:
+            sys.exit(f"{path}: sampled at {wav.getframerate()} Hz, expected {sample_rate} Hz")
+        return wav.readframes(wav.getnframes())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("inputs", nargs="+", type=pathlib.Path,
+                        help="WAV files, or directories searched recursively for WAV files")
+    parser.add_argument("-o", "--output", type=pathlib.Path, required=True,
+                        help="Output binary file")
+    parser.add_argument("--sample-rate", type=int, default=16000,
+                        help="Expected sampling rate in Hz (default: %(default)s)")
+    args = parser.parse_args()
+
+    files = []
+    for path in args.inputs:
+        files.extend(sorted(path.rglob("*.wav")) if path.is_dir() else [path])
+    if not files:
+        sys.exit("No WAV files found")
+
+    offset = HEADER.size + ENTRY.size * len(files)
+    entries = bytearray()
+    data = bytearray()
+    for path in files:
+        pcm = read_wav(path, args.sample_rate)
+        label = path.parent.name
+        label_idx = LABELS.index(label) if label in LABELS else -1
+        entries += ENTRY.pack(offset + len(data), len(pcm) // 2, label_idx, 0)
+        data += pcm
+
+    blob = HEADER.pack(MAGIC, VERSION, args.sample_rate, len(files)) + entries + data
+    if len(blob) > MAX_SIZE:
+        sys.exit(f"{len(blob)} bytes do not fit in the {MAX_SIZE} byte runtime_ifm region")
+
+    args.output.write_bytes(blob)
+    print(f"Packed {len(files)} clips into {args.output} ({len(blob)} bytes)")
+
+
+if __name__ == "__main__":
+    main()
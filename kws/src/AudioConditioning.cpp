@@ -0,0 +1,210 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AudioConditioning.hpp"
+
+#include "arm_math.h" /* CMSIS-DSP q15 helpers and intrinsics. */
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#endif /* defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1) */
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /* Folds one raw sample into the block statistics. */
+    static inline void AccumulateSample(int16_t sample, int32_t& sum, int16_t& min, int16_t& max)
+    {
+        sum += sample;
+        min = std::min(min, sample);
+        max = std::max(max, sample);
+    }
+
+    /* Offset and apply the gain to one sample the same way the vector paths do. */
+    static inline int32_t ConditionSample(int16_t sample, int32_t offset, int32_t gain)
+    {
+        int32_t value = ((static_cast<int32_t>(sample) + offset) * gain) >> ms_gainFracBits;
+        value         = std::min<int32_t>(value, std::numeric_limits<int16_t>::max());
+        value         = std::max<int32_t>(value, std::numeric_limits<int16_t>::min());
+        return value;
+    }
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    /* Saturating multiply of eight q15 lanes by a fractional gain, via 32-bit products. */
+    static inline int16x8_t ScaleSat(int16x8_t x, int32_t gain)
+    {
+        const int32x4_t even = vmulq_n_s32(vmovlbq_s16(x), gain);
+        const int32x4_t odd  = vmulq_n_s32(vmovltq_s16(x), gain);
+        int16x8_t res        = vqshrnbq_n_s32(vdupq_n_s16(0), even, ms_gainFracBits);
+        return vqshrntq_n_s32(res, odd, ms_gainFracBits);
+    }
+#elif defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    /* Scales a gain product from SMUAD/SMUADX back to 16 bits with saturation. CMSIS-Core
+     * declares these intrinsics as returning uint32_t, so the product is made signed first
+     * to get an arithmetic shift. */
+    static inline int32_t ScaleProduct(uint32_t product)
+    {
+        return __SSAT(static_cast<int32_t>(product) >> ms_gainFracBits, 16);
+    }
+#endif /* MVE or DSP */
+
+    void ConditionStereoToMono(const int16_t* stereo,
+                               int16_t* mono,
+                               uint32_t nFrames,
+                               int32_t offset,
+                               int32_t gain,
+                               AudioBlockStats& stats)
+    {
+        /* Adding the offset with 16-bit saturation gives the same result as the 32-bit
+         * sum: whenever the sum overflows 16 bits, the scaled value saturates anyway
+         * (gain is at least 1.0). */
+        const int16_t offset16 = static_cast<int16_t>(__SSAT(offset, 16));
+        uint32_t blkCnt        = nFrames;
+        int32_t sum            = 0;
+        int16_t min            = std::numeric_limits<int16_t>::max();
+        int16_t max            = std::numeric_limits<int16_t>::min();
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+        int16x8_t vMin = vdupq_n_s16(min);
+        int16x8_t vMax = vdupq_n_s16(max);
+
+        /* Eight frames per iteration; vld2q de-interleaves left and right channels. */
+        for (; blkCnt >= 8; blkCnt -= 8) {
+            const int16x8x2_t lr = vld2q_s16(stereo);
+
+            sum  = vaddvaq_s16(vaddvaq_s16(sum, lr.val[0]), lr.val[1]);
+            vMin = vminq_s16(vMin, vminq_s16(lr.val[0], lr.val[1]));
+            vMax = vmaxq_s16(vMax, vmaxq_s16(lr.val[0], lr.val[1]));
+
+            const int16x8_t left  = ScaleSat(vqaddq_n_s16(lr.val[0], offset16), gain);
+            const int16x8_t right = ScaleSat(vqaddq_n_s16(lr.val[1], offset16), gain);
+
+            vst1q_s16(mono, vaddq_s16(vshrq_n_s16(left, 1), vshrq_n_s16(right, 1)));
+
+            stereo += 16;
+            mono += 8;
+        }
+
+        min = vminvq_s16(min, vMin);
+        max = vmaxvq_s16(max, vMax);
+#elif defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+        /* One frame per 32-bit word: both channels are offset in one SIMD32 operation,
+         * then SMUAD/SMUADX against (0, gain) multiply the bottom/top channel. SMLAD
+         * against (1, 1) sums both raw channels into the statistics. */
+        const uint32_t offsetPair = (static_cast<uint16_t>(offset16) * 0x00010001UL);
+        const uint32_t gainPair   = static_cast<uint16_t>(gain);
+        for (; blkCnt >= 2; blkCnt -= 2) {
+            const uint32_t raw0 = read_q15x2_ia(&stereo);
+            const uint32_t raw1 = read_q15x2_ia(&stereo);
+
+            sum = __SMLAD(raw0, 0x00010001UL, __SMLAD(raw1, 0x00010001UL, sum));
+            for (const uint32_t raw : {raw0, raw1}) {
+                min = std::min({min, static_cast<int16_t>(raw), static_cast<int16_t>(raw >> 16)});
+                max = std::max({max, static_cast<int16_t>(raw), static_cast<int16_t>(raw >> 16)});
+            }
+
+            const uint32_t x0 = __QADD16(raw0, offsetPair);
+            const uint32_t x1 = __QADD16(raw1, offsetPair);
+
+            *mono++ = static_cast<int16_t>((ScaleProduct(__SMUAD(x0, gainPair)) >> 1) +
+                                           (ScaleProduct(__SMUADX(x0, gainPair)) >> 1));
+            *mono++ = static_cast<int16_t>((ScaleProduct(__SMUAD(x1, gainPair)) >> 1) +
+                                           (ScaleProduct(__SMUADX(x1, gainPair)) >> 1));
+        }
+#endif /* MVE or DSP */
+
+        for (; blkCnt > 0; --blkCnt) {
+            AccumulateSample(stereo[0], sum, min, max);
+            AccumulateSample(stereo[1], sum, min, max);
+
+            const int32_t left  = ConditionSample(*stereo++, offset16, gain);
+            const int32_t right = ConditionSample(*stereo++, offset16, gain);
+            *mono++             = static_cast<int16_t>((left >> 1) + (right >> 1));
+        }
+
+        stats.sum   = sum;
+        stats.count = nFrames * 2;
+        stats.min   = min;
+        stats.max   = max;
+    }
+
+    void ConditionMono(const int16_t* in,
+                       int16_t* out,
+                       uint32_t nSamples,
+                       int32_t offset,
+                       int32_t gain,
+                       AudioBlockStats& stats)
+    {
+        const int16_t offset16 = static_cast<int16_t>(__SSAT(offset, 16));
+        uint32_t blkCnt        = nSamples;
+        int32_t sum            = 0;
+        int16_t min            = std::numeric_limits<int16_t>::max();
+        int16_t max            = std::numeric_limits<int16_t>::min();
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+        int16x8_t vMin = vdupq_n_s16(min);
+        int16x8_t vMax = vdupq_n_s16(max);
+
+        for (; blkCnt >= 8; blkCnt -= 8) {
+            const int16x8_t x = vld1q_s16(in);
+
+            sum  = vaddvaq_s16(sum, x);
+            vMin = vminq_s16(vMin, x);
+            vMax = vmaxq_s16(vMax, x);
+
+            vst1q_s16(out, ScaleSat(vqaddq_n_s16(x, offset16), gain));
+
+            in += 8;
+            out += 8;
+        }
+
+        min = vminvq_s16(min, vMin);
+        max = vmaxvq_s16(max, vMax);
+#elif defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+        const uint32_t offsetPair = (static_cast<uint16_t>(offset16) * 0x00010001UL);
+        const uint32_t gainPair   = static_cast<uint16_t>(gain);
+        for (; blkCnt >= 2; blkCnt -= 2) {
+            const uint32_t raw = read_q15x2_ia(&in);
+
+            sum = __SMLAD(raw, 0x00010001UL, sum);
+            min = std::min({min, static_cast<int16_t>(raw), static_cast<int16_t>(raw >> 16)});
+            max = std::max({max, static_cast<int16_t>(raw), static_cast<int16_t>(raw >> 16)});
+
+            const uint32_t x = __QADD16(raw, offsetPair);
+            *out++ = static_cast<int16_t>(ScaleProduct(__SMUAD(x, gainPair)));
+            *out++ = static_cast<int16_t>(ScaleProduct(__SMUADX(x, gainPair)));
+        }
+#endif /* MVE or DSP */
+
+        for (; blkCnt > 0; --blkCnt) {
+            AccumulateSample(*in, sum, min, max);
+            *out++ = static_cast<int16_t>(ConditionSample(*in++, offset16, gain));
+        }
+
+        stats.sum   = sum;
+        stats.count = nSamples;
+        stats.min   = min;
+        stats.max   = max;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AutomaticGainControl.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /* Largest gain representable by the conditioning functions. */
+    static constexpr float ms_gainLimit = 32.f - 1.f / (1 << ms_gainFracBits);
+
+    AutomaticGainControl::AutomaticGainControl(
+        int32_t targetSpan, float maxGain, float offsetSmoothing, float attack, float release)
+        : m_targetSpan(static_cast<float>(targetSpan)),
+          m_maxGain(std::min(std::max(maxGain, 1.f), ms_gainLimit)),
+          m_offsetSmoothing(offsetSmoothing), m_attack(attack), m_release(release)
+    {}
+
+    void AutomaticGainControl::Update(const AudioBlockStats& stats)
+    {
+        if (0 == stats.count) {
+            return;
+        }
+
+        const float mean = static_cast<float>(stats.sum) / stats.count;
+        const float span = static_cast<float>(stats.max) - stats.min;
+
+        if (!this->m_primed) {
+            this->m_dcEstimate   = mean;
+            this->m_spanEnvelope = span;
+            this->m_primed       = true;
+        } else {
+            const float spanWeight = span > this->m_spanEnvelope ? this->m_attack : this->m_release;
+            this->m_dcEstimate += this->m_offsetSmoothing * (mean - this->m_dcEstimate);
+            this->m_spanEnvelope += spanWeight * (span - this->m_spanEnvelope);
+        }
+
+        /* We don't want random silence to be amplified too much; we limit the gain. */
+        float gain = this->m_maxGain;
+        if (this->m_spanEnvelope > 0.f) {
+            gain = std::min(std::max(this->m_targetSpan / this->m_spanEnvelope, 1.f),
+                            this->m_maxGain);
+        }
+
+        this->m_offset = static_cast<int32_t>(std::lround(-this->m_dcEstimate));
+        this->m_gain   = static_cast<int32_t>(gain * (1 << ms_gainFracBits));
+    }
+
+    void AutomaticGainControl::Reset()
+    {
+        this->m_primed       = false;
+        this->m_dcEstimate   = 0.f;
+        this->m_spanEnvelope = 0.f;
+        this->m_offset       = 0;
+        this->m_gain         = 1 << ms_gainFracBits;
+    }
+
+    int32_t AutomaticGainControl::GetOffset() const
+    {
+        return this->m_offset;
+    }
+
+    int32_t AutomaticGainControl::GetGain() const
+    {
+        return this->m_gain;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
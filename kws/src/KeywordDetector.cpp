@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "KeywordDetector.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace arm {
+namespace app {
+namespace kws {
+
+    KeywordDetector::KeywordDetector(const DetectorConfig& config) : m_config(config)
+    {
+        this->m_config.averageWindows =
+            std::min(std::max(this->m_config.averageWindows, 1u), ms_maxAverageWindows);
+    }
+
+    uint32_t KeywordDetector::AverageWindowsForLatency(float latencyBudgetSeconds,
+                                                       float strideSeconds)
+    {
+        if (strideSeconds <= 0.f || latencyBudgetSeconds < strideSeconds) {
+            return 1;
+        }
+        return std::min(static_cast<uint32_t>(latencyBudgetSeconds / strideSeconds),
+                        ms_maxAverageWindows);
+    }
+
+    bool KeywordDetector::Update(const float (&posteriors)[numLabels],
+                                 float timeStamp,
+                                 uint32_t inferenceNumber,
+                                 KwsIndexResult& event)
+    {
+        /* Replace the oldest posteriors in the history. */
+        std::copy(
+            std::begin(posteriors), std::end(posteriors), this->m_history[this->m_historyIdx]);
+        if (this->m_historyCount < this->m_config.averageWindows) {
+            ++this->m_historyCount;
+        }
+        this->m_historyIdx = (this->m_historyIdx + 1) % this->m_config.averageWindows;
+
+        /* Sum the held posteriors afresh every window rather than keeping a running sum,
+         * which would accumulate rounding error on a long-running device. The history is
+         * filled from slot 0, so the first m_historyCount slots are the ones in use. */
+        float sum[numLabels]{};
+        for (uint32_t w = 0; w < this->m_historyCount; ++w) {
+            for (uint32_t i = 0; i < numLabels; ++i) {
+                sum[i] += this->m_history[w][i];
+            }
+        }
+
+        const float norm = 1.f / this->m_historyCount;
+
+        /* A detection in progress ends once its keyword drops below the release threshold. */
+        if (this->m_activeLabelIdx != noLabelIdx) {
+            if (sum[this->m_activeLabelIdx] * norm >= this->m_config.releaseThreshold) {
+                return false;
+            }
+            this->m_activeLabelIdx = noLabelIdx;
+        }
+
+        if (this->m_detectedAny && timeStamp < this->m_refractoryEnd) {
+            return false;
+        }
+
+        uint32_t bestIdx = noLabelIdx;
+        float bestScore  = this->m_config.triggerThreshold;
+        for (uint32_t i = 0; i < numLabels; ++i) {
+            if (i == silenceLabelIdx || i == unknownLabelIdx) {
+                continue;
+            }
+            const float score = sum[i] * norm;
+            if (score >= bestScore) {
+                bestIdx   = i;
+                bestScore = score;
+            }
+        }
+
+        if (bestIdx == noLabelIdx) {
+            return false;
+        }
+
+        this->m_activeLabelIdx = bestIdx;
+        this->m_refractoryEnd  = timeStamp + this->m_config.refractorySeconds;
+        this->m_detectedAny    = true;
+
+        event.timeStamp       = timeStamp;
+        event.inferenceNumber = inferenceNumber;
+        event.labelIdx        = bestIdx;
+        event.score           = bestScore;
+        return true;
+    }
+
+    void KeywordDetector::Reset()
+    {
+        std::memset(this->m_history, 0, sizeof(this->m_history));
+        this->m_historyIdx     = 0;
+        this->m_historyCount   = 0;
+        this->m_activeLabelIdx = noLabelIdx;
+        this->m_refractoryEnd  = 0.f;
+        this->m_detectedAny    = false;
+    }
+
+} /* namespace kws */
+} /* namespace app */
+} /* namespace arm */
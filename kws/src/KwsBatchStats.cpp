@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "KwsBatchStats.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace arm {
+namespace app {
+namespace kws {
+
+    void KwsBatchStats::AddWindow(bool inferred)
+    {
+        ++this->m_windows;
+        if (inferred) {
+            ++this->m_inferences;
+        }
+    }
+
+    void KwsBatchStats::AddClip(int32_t expectedIdx, uint32_t predictedIdx)
+    {
+        ++this->m_clips;
+        if (expectedIdx < 0 || static_cast<uint32_t>(expectedIdx) >= numLabels ||
+            predictedIdx >= numLabels) {
+            return;
+        }
+
+        ++this->m_labelledClips;
+        ++this->m_confusion[expectedIdx][predictedIdx];
+        if (static_cast<uint32_t>(expectedIdx) == predictedIdx) {
+            ++this->m_correctClips;
+        }
+    }
+
+    void KwsBatchStats::Print(uint32_t ticksPerSecond, uint64_t totalTicks) const
+    {
+        const double seconds =
+            ticksPerSecond ? static_cast<double>(totalTicks) / ticksPerSecond : 0.0;
+
+        printf("BEGIN KWS_BATCH_REPORT\n");
+        printf("clips,%" PRIu32 "\n", this->m_clips);
+        printf("windows,%" PRIu32 "\n", this->m_windows);
+        printf("inferences,%" PRIu32 "\n", this->m_inferences);
+        printf("ticks_per_second,%" PRIu32 "\n", ticksPerSecond);
+        printf("ticks_total,%" PRIu64 "\n", totalTicks);
+        printf("windows_per_second,%.2f\n", seconds > 0.0 ? this->m_windows / seconds : 0.0);
+        printf("inferences_per_second,%.2f\n",
+               seconds > 0.0 ? this->m_inferences / seconds : 0.0);
+        printf("top1,%" PRIu32 ",%" PRIu32 ",%.4f\n",
+               this->m_correctClips,
+               this->m_labelledClips,
+               this->m_labelledClips
+                   ? static_cast<double>(this->m_correctClips) / this->m_labelledClips
+                   : 0.0);
+
+        /* One row per expected label, one column per predicted label. */
+        printf("confusion,expected");
+        for (uint32_t j = 0; j < numLabels; ++j) {
+            printf(",%s", labelTable[j]);
+        }
+        printf("\n");
+        for (uint32_t i = 0; i < numLabels; ++i) {
+            printf("confusion,%s", labelTable[i]);
+            for (uint32_t j = 0; j < numLabels; ++j) {
+                printf(",%" PRIu32, this->m_confusion[i][j]);
+            }
+            printf("\n");
+        }
+        printf("END KWS_BATCH_REPORT\n");
+    }
+
+} /* namespace kws */
+} /* namespace app */
+} /* namespace arm */
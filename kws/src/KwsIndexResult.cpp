@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "KwsIndexResult.hpp"
+
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace arm {
+namespace app {
+namespace kws {
+
+    /* Softmax of n (quantised) logits, subtracting the largest one for numerical stability.
+     * The quantisation zero point cancels out in the subtraction, so only the scale is
+     * needed. */
+    template <typename T>
+    static void Softmax(const T* data, size_t n, float scale, float* out)
+    {
+        T maxVal = data[0];
+        for (size_t i = 1; i < n; ++i) {
+            maxVal = std::max(maxVal, data[i]);
+        }
+
+        float sum = 0.f;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = std::exp(scale * (static_cast<float>(data[i]) - maxVal));
+            sum += out[i];
+        }
+        for (size_t i = 0; i < n; ++i) {
+            out[i] /= sum;
+        }
+    }
+
+    bool GetPosteriors(TfLiteTensor* outputTensor, float (&posteriors)[numLabels])
+    {
+        if (!outputTensor) {
+            printf_err("Output tensor is null\n");
+            return false;
+        }
+
+        switch (outputTensor->type) {
+        case kTfLiteInt8: {
+            if (outputTensor->bytes != numLabels) {
+                printf_err("Output tensor size does not match the number of labels\n");
+                return false;
+            }
+            const QuantParams quantParams = GetTensorQuantParams(outputTensor);
+            Softmax(tflite::GetTensorData<int8_t>(outputTensor),
+                    numLabels,
+                    quantParams.scale,
+                    posteriors);
+            break;
+        }
+        case kTfLiteFloat32:
+            if (outputTensor->bytes != numLabels * sizeof(float)) {
+                printf_err("Output tensor size does not match the number of labels\n");
+                return false;
+            }
+            Softmax(tflite::GetTensorData<float>(outputTensor), numLabels, 1.f, posteriors);
+            break;
+        default:
+            printf_err("Tensor type %s not supported\n", TfLiteTypeGetName(outputTensor->type));
+            return false;
+        }
+
+        return true;
+    }
+
+    void GetTopResult(const float (&posteriors)[numLabels],
+                      float scoreThreshold,
+                      KwsIndexResult& result)
+    {
+        uint32_t idx = 0;
+        for (uint32_t i = 1; i < numLabels; ++i) {
+            if (posteriors[i] > posteriors[idx]) {
+                idx = i;
+            }
+        }
+
+        result.labelIdx = posteriors[idx] >= scoreThreshold ? idx : noLabelIdx;
+        result.score    = posteriors[idx];
+    }
+
+} /* namespace kws */
+} /* namespace app */
+} /* namespace arm */
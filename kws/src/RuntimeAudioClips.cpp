@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RuntimeAudioClips.hpp"
+
+#include "log_macros.h"
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    bool RuntimeAudioClips::Init(const void* region, size_t regionSize)
+    {
+        this->m_base      = nullptr;
+        this->m_entries   = nullptr;
+        this->m_clipCount = 0;
+
+        if (!region || regionSize < sizeof(RuntimeClipsHeader)) {
+            return false;
+        }
+
+        const auto* base   = static_cast<const uint8_t*>(region);
+        const auto* header = reinterpret_cast<const RuntimeClipsHeader*>(base);
+
+        if (header->magic != ms_runtimeClipsMagic) {
+            /* Nothing was loaded; not an error. */
+            return false;
+        }
+
+        if (header->version != ms_runtimeClipsVersion) {
+            printf_err("Unsupported runtime clips version %" PRIu32 "\n", header->version);
+            return false;
+        }
+
+        /* Bounds are checked in 64 bits so that corrupt sizes cannot wrap around. */
+        const uint64_t tableEnd =
+            sizeof(RuntimeClipsHeader) +
+            static_cast<uint64_t>(header->clipCount) * sizeof(RuntimeClipEntry);
+        if (0 == header->clipCount || tableEnd > regionSize) {
+            printf_err("Invalid runtime clip count %" PRIu32 "\n", header->clipCount);
+            return false;
+        }
+
+        const auto* entries =
+            reinterpret_cast<const RuntimeClipEntry*>(base + sizeof(RuntimeClipsHeader));
+        for (uint32_t i = 0; i < header->clipCount; ++i) {
+            const RuntimeClipEntry& entry = entries[i];
+            const uint64_t dataEnd = static_cast<uint64_t>(entry.dataOffset) +
+                                     static_cast<uint64_t>(entry.sampleCount) * sizeof(int16_t);
+
+            if (entry.dataOffset < tableEnd || (entry.dataOffset % sizeof(int16_t)) ||
+                dataEnd > regionSize) {
+                printf_err("Runtime clip %" PRIu32 " lies outside the region\n", i);
+                return false;
+            }
+        }
+
+        this->m_base       = base;
+        this->m_entries    = entries;
+        this->m_clipCount  = header->clipCount;
+        this->m_sampleRate = header->sampleRate;
+        return true;
+    }
+
+    uint32_t RuntimeAudioClips::GetClipCount() const
+    {
+        return this->m_clipCount;
+    }
+
+    uint32_t RuntimeAudioClips::GetSampleRate() const
+    {
+        return this->m_sampleRate;
+    }
+
+    const int16_t* RuntimeAudioClips::GetClip(uint32_t idx) const
+    {
+        if (idx < this->m_clipCount) {
+            return reinterpret_cast<const int16_t*>(this->m_base + this->m_entries[idx].dataOffset);
+        }
+        return nullptr;
+    }
+
+    uint32_t RuntimeAudioClips::GetClipSize(uint32_t idx) const
+    {
+        if (idx < this->m_clipCount) {
+            return this->m_entries[idx].sampleCount;
+        }
+        return 0;
+    }
+
+    int32_t RuntimeAudioClips::GetClipLabel(uint32_t idx) const
+    {
+        if (idx < this->m_clipCount) {
+            return this->m_entries[idx].labelIdx;
+        }
+        return -1;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StreamingKwsPreProcess.hpp"
+
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    StreamingKwsPreProcess::StreamingKwsPreProcess(TfLiteTensor* inputTensor,
+                                                   size_t numFeatures,
+                                                   size_t numFeatureFrames,
+                                                   uint32_t mfccFrameLength,
+                                                   uint32_t mfccFrameStride)
+        : m_audioDataWindowSize{numFeatureFrames * mfccFrameStride +
+                                (mfccFrameLength - mfccFrameStride)},
+          m_inputTensor{inputTensor}, m_numFeatures{numFeatures},
+          m_numFeatureFrames{numFeatureFrames}, m_mfccFrameLength{mfccFrameLength},
+          m_mfccFrameStride{mfccFrameStride}, m_quantParams{GetTensorQuantParams(inputTensor)},
+          m_mfcc{numFeatures, mfccFrameLength}, m_frameAudio(mfccFrameLength),
+          m_features(numFeatures * numFeatureFrames)
+    {
+        this->m_mfcc.Init();
+    }
+
+    bool StreamingKwsPreProcess::Update(const int16_t* window, size_t newSamples)
+    {
+        if (window == nullptr || newSamples % this->m_mfccFrameStride != 0) {
+            printf_err("Audio must advance by whole MFCC strides\n");
+            return false;
+        }
+
+        /* Windows ending in the new samples; the older ones slide down by as many rows. */
+        size_t newFrames = newSamples / this->m_mfccFrameStride;
+        if (!this->m_primed || newFrames > this->m_numFeatureFrames) {
+            newFrames      = this->m_numFeatureFrames;
+            this->m_primed = true;
+        }
+        this->m_oldestRow = (this->m_oldestRow + newFrames) % this->m_numFeatureFrames;
+
+        for (size_t frame = this->m_numFeatureFrames - newFrames;
+             frame < this->m_numFeatureFrames;
+             ++frame) {
+            const int16_t* frameStart = window + frame * this->m_mfccFrameStride;
+            std::copy(frameStart, frameStart + this->m_mfccFrameLength, this->m_frameAudio.begin());
+
+            const std::vector<int8_t> features = this->m_mfcc.MfccComputeQuant<int8_t>(
+                this->m_frameAudio, this->m_quantParams.scale, this->m_quantParams.offset);
+            if (features.size() != this->m_numFeatures) {
+                printf_err("Unexpected number of MFCC features\n");
+                return false;
+            }
+
+            const size_t row = (this->m_oldestRow + frame) % this->m_numFeatureFrames;
+            std::copy(features.begin(),
+                      features.end(),
+                      this->m_features.begin() + row * this->m_numFeatures);
+        }
+        return true;
+    }
+
+    bool StreamingKwsPreProcess::CopyToInput()
+    {
+        if (this->m_inputTensor->type != kTfLiteInt8 ||
+            this->m_inputTensor->bytes != this->m_features.size()) {
+            printf_err("Input tensor does not match the MFCC features\n");
+            return false;
+        }
+
+        /* Ring rows from the oldest window on, then the ones that wrapped around. */
+        auto* input             = static_cast<int8_t*>(this->m_inputTensor->data.data);
+        const size_t splitBytes = this->m_oldestRow * this->m_numFeatures;
+        std::memcpy(input,
+                    this->m_features.data() + splitBytes,
+                    this->m_features.size() - splitBytes);
+        std::memcpy(
+            input + this->m_features.size() - splitBytes, this->m_features.data(), splitBytes);
+        return true;
+    }
+
+} /* namespace app */
+} /* namespace arm */
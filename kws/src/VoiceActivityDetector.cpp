@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VoiceActivityDetector.hpp"
+
+#include "arm_math.h" /* CMSIS-DSP power function. */
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    VoiceActivityDetector::VoiceActivityDetector(const VadConfig& config)
+        : m_config(config),
+          m_energyThreshold(static_cast<int64_t>(config.energyThreshold) *
+                            config.energyThreshold * config.frameLength)
+    {}
+
+    bool VoiceActivityDetector::IsActive(const int16_t* window, uint32_t nSamples)
+    {
+        const uint32_t frameLength = this->m_config.frameLength;
+        uint32_t activeFrames      = 0;
+
+        for (uint32_t i = 0; i + frameLength <= nSamples; i += frameLength) {
+            if (this->IsFrameActive(window + i, frameLength) &&
+                ++activeFrames >= this->m_config.minActiveFrames) {
+                this->m_hangoverLeft = this->m_config.hangoverWindows;
+                return true;
+            }
+        }
+
+        if (this->m_hangoverLeft > 0) {
+            --this->m_hangoverLeft;
+            return true;
+        }
+        return false;
+    }
+
+    void VoiceActivityDetector::Reset()
+    {
+        this->m_hangoverLeft = 0;
+    }
+
+    bool VoiceActivityDetector::IsFrameActive(const int16_t* frame, uint32_t nSamples) const
+    {
+        /* Sum of squares of the samples; 34.30 format is the plain integer sum. */
+        q63_t energy = 0;
+        arm_power_q15(frame, nSamples, &energy);
+
+        if (energy >= this->m_energyThreshold) {
+            return true;
+        }
+
+        /* Quieter frames only count when they look like unvoiced speech. */
+        if (energy < this->m_energyThreshold / 4) {
+            return false;
+        }
+
+        uint32_t zeroCrossings = 0;
+        for (uint32_t i = 1; i < nSamples; ++i) {
+            zeroCrossings += (frame[i] ^ frame[i - 1]) < 0 ? 1 : 0;
+        }
+        return zeroCrossings > this->m_config.zcrThreshold;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -23,16 +23,23 @@
  * the memory requirements for TensorFlow Lite Micro framework and
  * some heap for the API runtime.
  */
-#include "AudioUtils.hpp"       /* Generic audio utilities like sliding windows. */
-#include "BufAttributes.hpp"    /* Buffer attributes to be applied. */
-#include "Classifier.hpp"       /* Classifier for the result. */
-#include "KwsProcessing.hpp"    /* Pre and Post Process. */
-#include "KwsResult.hpp"        /* KWS results class. */
-#include "Labels.hpp"           /* Label Data for the model. */
-#include "MicroNetKwsModel.hpp" /* Model API. */
-
+#include "AudioBlockQueue.hpp"        /* Queue decoupling audio capture from inference. */
+#include "AudioConditioning.hpp"      /* Offset, gain and stereo to mono conversion. */
+#include "AudioUtils.hpp"             /* Generic audio utilities like sliding windows. */
+#include "AutomaticGainControl.hpp"   /* Streaming offset and gain estimation. */
+#include "BufAttributes.hpp"          /* Buffer attributes to be applied. */
+#include "KeywordDetector.hpp"        /* Posterior smoothing and keyword events. */
+#include "KwsIndexResult.hpp"         /* Allocation free KWS results. */
+#include "KwsProcessing.hpp"          /* Pre and Post Process. */
+#include "Labels.hpp"                 /* Label Data for the model. */
+#include "MicroNetKwsModel.hpp"       /* Model API. */
+#include "StreamingKwsPreProcess.hpp" /* Feature extraction for the newest audio only. */
+#include "VoiceActivityDetector.hpp"  /* Gate for windows without speech. */
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <string>
-#include <vector>
 
 /* Platform dependent files */
 #include "RTE_Components.h"  /* Provides definition for CMSIS_device_header */
@@ -43,21 +50,46 @@
 #include "BoardAudioUtils.hpp" /* Board specific audio utilities - recording audio. */
 #include "BoardPlotUtils.hpp"  /* Board specific display utilities. */
 
+/* Time between consecutive inference windows in milliseconds, a multiple of the 20 ms MFCC
+ * stride. Every hop, the newest hop of audio is appended to the one second history fed to the
+ * model and one window is classified. */
+#ifndef KWS_LIVE_HOP_MS
+#define KWS_LIVE_HOP_MS 240
+#endif /* KWS_LIVE_HOP_MS */
+
 namespace arm {
 namespace app {
 
+    static constexpr uint32_t audioSamplingFreq = 16000; /* Sampling rate of the model. */
+    static constexpr uint32_t audioChannels     = 2;     /* Supported boards record stereo. */
+    static constexpr uint32_t windowSamples     = audioSamplingFreq;
+    static constexpr uint32_t hopSamples        = audioSamplingFreq * KWS_LIVE_HOP_MS / 1000;
+    static constexpr uint32_t mfccFrameLength   = 640;
+    static constexpr uint32_t mfccFrameStride   = 320;
+    static_assert(hopSamples > 0 && hopSamples <= windowSamples,
+                  "KWS_LIVE_HOP_MS must be between 1 and 1000");
+    static_assert(hopSamples % mfccFrameStride == 0,
+                  "KWS_LIVE_HOP_MS must be a multiple of the 20 ms MFCC stride");
+
     /* Tensor arena buffer */
     static uint8_t tensorArena[ACTIVATION_BUF_SZ] ACTIVATION_BUF_ATTRIBUTE;
-    static int16_t audioBufferDMA[16000]; /* half a second worth of stereo audio or full second worth of mono */
-    static int16_t audioBufferForNN[16000]; /* one full second worth of mono audio */
+    /* Two ping-pong halves, each one hop worth of captured audio. Aligned to the D-cache
+     * line so invalidating a half does not discard neighbouring data. */
+    static int16_t audioBufferDMA[2 * hopSamples * audioChannels] __attribute__((aligned(32)));
+    /* Latest second worth of mono audio as a ring, stored twice in a row so the window fed
+     * to the model is contiguous wherever it starts in the ring. */
+    static int16_t audioHistory[2 * windowSamples];
 
     static audio_buf dmaBuf = {.data       = audioBufferDMA,
                                .n_elements = sizeof(audioBufferDMA) >> 1,
                                .n_bytes    = sizeof(audioBufferDMA)};
 
-    static audio_buf monoBuf = {.data       = audioBufferForNN,
-                                .n_elements = sizeof(audioBufferForNN) >> 1,
-                                .n_bytes    = sizeof(audioBufferForNN)};
+    /* Captured halves of the DMA buffer, queued in place from the audio interrupt so capture
+     * keeps going while the application is busy with feature extraction and inference.
+     * A queued half stays intact until the DMA has filled the other half as well, so each
+     * hop has to be consumed within one hop of being captured. */
+    static constexpr size_t audioBlockElements = hopSamples * audioChannels;
+    static audio::AudioBlockQueue<int16_t, 4> audioQueue;
 
     /* Optional getter function for the model pointer and its size. */
     namespace kws {
@@ -71,16 +103,9 @@ namespace app {
 __asm("  .global __ARM_use_no_argv\n");
 #endif
 
-static int32_t CalculateOffset(audio_buf* audioBuffer);
-
-static int32_t CalculateScale(audio_buf* audioBuffer);
+static void QueueCapturedAudio(const void* data, uint32_t nElements);
+static void MirrorHistory(size_t start, size_t nSamples);
 
-static void ApplyGainAndOffset(audio_buf* audioBuffer, int32_t audioOffset, int32_t audioScale);
-
-static void ConvertToMono(audio_buf* stereo,
-                          audio_buf* mono,
-                          uint32_t stereoStartIdx,
-                          uint32_t monoStartIndex);
 
 int main()
 {
@@ -101,9 +126,7 @@ int main()
             ? arm::app::MicroNetKwsModel::ms_inputRowsIdx
             : arm::app::MicroNetKwsModel::ms_inputColsIdx);
 
-    const auto mfccFrameLength = 640;
-    const auto mfccFrameStride = 320;
-    const auto scoreThreshold  = 0.7;
+    const auto scoreThreshold = 0.7;
 
     /* Get Input and Output tensors for pre/post processing. */
     TfLiteTensor* inputTensor  = model.GetInputTensor(0);
@@ -125,90 +148,150 @@ int main()
      * NOTE: This is only used for time stamp calculation. */
     const float secondsPerSample = 1.0 / arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq;
 
-    /* Classifier object for results */
-    arm::app::KwsClassifier classifier;
-
-    /* Object to hold label strings. */
-    std::vector<std::string> labels;
-
-    /* Declare a container to hold results from across the whole audio clip. */
-    std::vector<arm::app::kws::KwsResult> finalResults;
-
-    /* Object to hold classification results */
-    std::vector<arm::app::ClassificationResult> singleInfResult;
-
-    /* Populate the labels here. */
-    GetLabelsVector(labels);
-
-    /* Set up pre and post-processing. */
-    arm::app::KwsPreProcess preProcess = arm::app::KwsPreProcess(
-        inputTensor, numMfccFeatures, numMfccFrames, mfccFrameLength, mfccFrameStride);
-
-    arm::app::KwsPostProcess postProcess =
-        arm::app::KwsPostProcess(outputTensor, classifier, labels, singleInfResult);
+    /* Keyword events detected since the last display update. The loop itself runs
+     * without heap allocations: results refer to labels by index. */
+    arm::app::kws::KwsResultRing<16> finalResults;
+
+    /* The detector sees each hop once, when it is captured: hold the decision for as long as
+     * an active hop stays in the window, plus one window for the tail of the utterance. */
+    arm::app::audio::VadConfig vadConfig{};
+    vadConfig.hangoverWindows =
+        (arm::app::windowSamples + arm::app::hopSamples - 1) / arm::app::hopSamples;
+    arm::app::audio::VoiceActivityDetector vad{vadConfig};
+
+    /* Set up pre-processing; post-processing computes the posteriors straight from the
+     * output tensor. */
+    arm::app::StreamingKwsPreProcess preProcess{inputTensor,
+                                                numMfccFeatures,
+                                                numMfccFrames,
+                                                arm::app::mfccFrameLength,
+                                                arm::app::mfccFrameStride};
+
+    if (inputTensor->type != kTfLiteInt8) {
+        printf_err("Only int8 model input is supported\n");
+        return 1;
+    } else if (preProcess.m_audioDataWindowSize != arm::app::windowSamples) {
+        printf_err("Model window of %" PRIu32 " samples does not match the audio history\n",
+                   static_cast<uint32_t>(preProcess.m_audioDataWindowSize));
+        return 1;
+    }
 
-    /* Creating a sliding window through the whole audio clip. */
-    auto audioDataSlider =
-        arm::app::audio::SlidingWindow<const int16_t>(static_cast<int16_t*>(arm::app::monoBuf.data),
-                                                      arm::app::monoBuf.n_elements,
-                                                      preProcess.m_audioDataWindowSize,
-                                                      preProcess.m_audioDataStride);
+    /* Posteriors are averaged over as many hops as the latency budget allows. */
+    const float hopSeconds = arm::app::hopSamples * secondsPerSample;
+    arm::app::kws::DetectorConfig detectorConfig{};
+    detectorConfig.averageWindows = arm::app::kws::KeywordDetector::AverageWindowsForLatency(
+        KWS_LATENCY_BUDGET_MS / 1000.f, hopSeconds);
+    detectorConfig.triggerThreshold = scoreThreshold;
+    arm::app::kws::KeywordDetector detector{detectorConfig};
+    float posteriors[arm::app::kws::numLabels];
 
     AudioUtils audio{};
+    if (audio.IsStereo() != (arm::app::audioChannels == 2)) {
+        printf_err("Unexpected number of audio channels\n");
+        return 1;
+    }
+
     audio.AudioInit(&arm::app::dmaBuf);
-    audio.StartAudioRecording();
+    audio.SetHalfFilledCallback(QueueCapturedAudio);
+    audio.StartContinuousRecording();
 
     PlotUtils plot{};
     uint32_t inferenceCount{0};
-    std::string lastValidKeywordDetected{};
+    uint32_t windowCount{0};
 
-    constexpr uint32_t scaleOffsetResetFreq = 5;
-    uint32_t captureCount                   = 0;
-    int32_t audioGain                       = 0;
-    int32_t audioOffset                     = 0;
+    /* Display text, with room reserved up front so updating it does not allocate. */
+    const std::string keywordPrefix{" Last Keyword: "};
+    std::string dispStr{};
+    dispStr.reserve(keywordPrefix.size() + 16);
 
-    while (true) {
+    /* Start of the window in the history ring; every captured hop takes the place of the
+     * oldest one. */
+    size_t windowStart = 0;
 
-        audioDataSlider.Reset();
+    /* Offset and gain follow the signal hop by hop, from statistics gathered while
+     * each hop is converted; every hop is conditioned with the estimates so far. */
+    arm::app::audio::AutomaticGainControl agc{};
+    arm::app::audio::AudioBlockStats blockStats{};
+    uint32_t overrunCount = 0;
+    uint32_t lostHops     = 0;
 
-        while (!audio.IsAudioAvailable()) {
+    while (true) {
+
+        /* Wait for the next hop; the audio interrupt keeps queueing new ones meanwhile. */
+        const int16_t* block = nullptr;
+        while (nullptr == (block = arm::app::audioQueue.Front())) {
             __WFI();
         }
-        audio.StopAudioRecording();
 
-        if (0 == captureCount++ % scaleOffsetResetFreq) {
-            audioOffset = CalculateOffset(&arm::app::dmaBuf);
-            audioGain = CalculateScale(&arm::app::dmaBuf);
+        /* A newer hop in the queue means the DMA is already refilling the half of this one:
+         * skip to the newest hop, whose half is still intact. */
+        while (arm::app::audioQueue.Size() > 1) {
+            arm::app::audioQueue.Pop();
+            block = arm::app::audioQueue.Front();
+            ++lostHops;
         }
 
-        ApplyGainAndOffset(&arm::app::dmaBuf, audioOffset, audioGain);
+        /* The new hop replaces the oldest one in the ring. Write it to whichever copy of
+         * that hop is contiguous, which is also where the next window ends. */
+        const size_t hopStart = (windowStart + arm::app::hopSamples <= arm::app::windowSamples)
+                                    ? windowStart + arm::app::windowSamples
+                                    : windowStart;
+        int16_t* const hopDst = &arm::app::audioHistory[hopStart];
+
+        const int32_t audioGain   = agc.GetGain();
+        const int32_t audioOffset = agc.GetOffset();
 
-        /* Copy over second half of previous audio buffer to the beginning */
-        memcpy(arm::app::monoBuf.data,
-               (void*)((uint8_t*)arm::app::monoBuf.data + arm::app::monoBuf.n_bytes / 2),
-               arm::app::monoBuf.n_bytes / 2);
+        debug("Scale: %d/%d; Offset: %d\n",
+              audioGain,
+              1 << arm::app::audio::ms_gainFracBits,
+              audioOffset);
 
+        /* Append the freshly captured audio, applying offset and gain on the way. */
         if (audio.IsStereo()) {
-            /* Populate the second half of the mono buffer from the freshly captured audio */
-            ConvertToMono(&arm::app::dmaBuf, &arm::app::monoBuf, 0, arm::app::monoBuf.n_elements / 2);
+            arm::app::audio::ConditionStereoToMono(
+                block, hopDst, arm::app::hopSamples, audioOffset, audioGain, blockStats);
         } else {
-            memcpy((void*)((uint8_t*)arm::app::monoBuf.data + arm::app::monoBuf.n_bytes / 2),
-                  arm::app::dmaBuf.data,
-                  arm::app::monoBuf.n_bytes / 2);
+            arm::app::audio::ConditionMono(
+                block, hopDst, arm::app::hopSamples, audioOffset, audioGain, blockStats);
+        }
+
+        agc.Update(blockStats);
+
+        MirrorHistory(hopStart, arm::app::hopSamples);
+        windowStart = (windowStart + arm::app::hopSamples) % arm::app::windowSamples;
+        const int16_t* const window = &arm::app::audioHistory[windowStart];
+
+        /* The half was being refilled while it was read: the hop is corrupt. */
+        if (arm::app::audioQueue.Size() > 1) {
+            ++lostHops;
         }
+        arm::app::audioQueue.Pop();
 
-        plot.PlotWaveform(static_cast<int16_t*>(arm::app::monoBuf.data),
-                          arm::app::monoBuf.n_elements);
+        if (lostHops + arm::app::audioQueue.GetOverrunCount() != overrunCount) {
+            overrunCount = lostHops + arm::app::audioQueue.GetOverrunCount();
+            warn("Audio capture overrun; %" PRIu32 " blocks lost so far\n", overrunCount);
+        }
 
-        /* Restart audio capture */
-        audio.SetAudioEmpty();
-        audio.StartAudioRecording();
+        plot.PlotWaveform(window, arm::app::windowSamples);
 
-        while (audioDataSlider.HasNext()) {
-            const int16_t* inferenceWindow = audioDataSlider.Next();
+        /* Features of the windows completed by the new hop; the rest are kept from before. */
+        if (!preProcess.Update(window, arm::app::hopSamples)) {
+            printf_err("Pre-processing failed.");
+            return 1;
+        }
+
+        /* Start of the window in time since capture started. */
+        const float timeStamp =
+            (static_cast<float>(windowCount + 1) * arm::app::hopSamples -
+             static_cast<float>(arm::app::windowSamples)) *
+            secondsPerSample;
 
-            /* Run the pre-processing, inference and post-processing. */
-            if (!preProcess.DoPreProcess(inferenceWindow, audioDataSlider.Index())) {
+        if (KWS_VAD_ENABLED && !vad.IsActive(hopDst, arm::app::hopSamples)) {
+            std::fill(std::begin(posteriors), std::end(posteriors), 0.f);
+            posteriors[arm::app::kws::silenceLabelIdx] = 1.f;
+        } else {
+            /* Run the inference and post-processing on the cached features. */
+            if (!preProcess.CopyToInput()) {
                 printf_err("Pre-processing failed.");
                 return 1;
             }
@@ -220,119 +303,66 @@ int main()
                 return 2;
             }
 
-            if (!postProcess.DoPostProcess()) {
+            if (!arm::app::kws::GetPosteriors(outputTensor, posteriors)) {
                 printf_err("Post-processing failed.");
                 return 3;
             }
+        }
 
-            /* Add results from this window to our final results vector. */
-            finalResults.emplace_back(arm::app::kws::KwsResult(
-                singleInfResult,
-                audioDataSlider.Index() * secondsPerSample * preProcess.m_audioDataStride,
-                audioDataSlider.Index(),
-                scoreThreshold));
-
-        } /* while (audioDataSlider.HasNext()) */
-
-        for (const auto& result : finalResults) {
-
-            std::string topKeyword{"<none>"};
-            float score = 0.f;
-            if (!result.m_resultVec.empty()) {
-                topKeyword = result.m_resultVec[0].m_label;
-                score      = result.m_resultVec[0].m_normalisedVal;
-
-                if (topKeyword != "<none>" && topKeyword != "_unknown_") {
-
-                    if (lastValidKeywordDetected != topKeyword) {
+        /* Add keywords completed by this window to our final results. */
+        arm::app::kws::KwsIndexResult event{};
+        if (detector.Update(posteriors, timeStamp, windowCount++, event)) {
+            finalResults.Push(event);
+        }
 
-                        /* Update last keyword. */
-                        lastValidKeywordDetected = topKeyword;
+        for (size_t i = 0; i < finalResults.Size(); ++i) {
+            const arm::app::kws::KwsIndexResult& detected = finalResults[i];
 
-                        info("Detected: %s; Prob: %0.2f\n", topKeyword.c_str(), score);
-                        plot.ClearStringLine(9);
-                        std::string dispStr = " Last Keyword: " + topKeyword;
-                        plot.DisplayStringAtLine(9, dispStr);
-                    }
-                }
-            }
+            info("Detected: %s; Prob: %0.2f; at %0.2f s\n",
+                 arm::app::kws::labelTable[detected.labelIdx],
+                 detected.score,
+                 detected.timeStamp);
+            plot.ClearStringLine(9);
+            dispStr.assign(keywordPrefix).append(arm::app::kws::labelTable[detected.labelIdx]);
+            plot.DisplayStringAtLine(9, dispStr);
         }
 
-        finalResults.clear();
+        finalResults.Clear();
     }
 
     return 0;
 }
 
-static void ConvertToMono(audio_buf* stereo,
-                          audio_buf* mono,
-                          uint32_t stereoStartIdx,
-                          uint32_t monoStartIndex)
+/**
+ * @brief   Called from the audio interrupt for every filled half of the DMA buffer; only
+ *          queues a pointer to it.
+ */
+static void QueueCapturedAudio(const void* data, uint32_t nElements)
 {
-    int16_t* pIn     = ((int16_t*)stereo->data) + stereoStartIdx;
-    int16_t* pOut    = ((int16_t*)mono->data) + monoStartIndex;
-    uint32_t sizeIn  = stereo->n_elements - stereoStartIdx;
-    uint32_t sizeOut = mono->n_elements - monoStartIndex;
-
-    for (int i = 0, j = 0; j < sizeIn && i < sizeOut; ++i, j += 2, pIn += 2) {
-        *pOut++ = ((pIn[0] >> 1) + (pIn[1] >> 1));
+    if (nElements == arm::app::audioBlockElements) {
+        arm::app::audioQueue.Push(static_cast<const int16_t*>(data));
     }
 }
 
-static int32_t CalculateOffset(audio_buf* audioBuffer)
-{
-    int16_t audioMean = 0;
-    arm_mean_q15((int16_t*)audioBuffer->data, audioBuffer->n_elements, &audioMean);
-    return static_cast<int32_t>(0 - audioMean);
-}
-
-static int32_t CalculateScale(audio_buf* audioBuffer)
+/**
+ * @brief   Copies samples just written to one copy of the history ring to the other copy.
+ * @param[in]   start      Index of the first sample written in audioHistory.
+ * @param[in]   nSamples   Number of samples written, at most one window.
+ */
+static void MirrorHistory(size_t start, size_t nSamples)
 {
-    /* Define the desired signal span to scale our input signal to. It can be based on
-     * the training data set, or close to std::numeric_limits<int16_t>::max()/2; */
-    constexpr int32_t desirableSignalSpan = 18000;
-
-    /* Maximum scaling factor. A factor bigger than this may amplify noise which can
-     * lead to false detections. */
-    constexpr int32_t maxScale = 25;
-
-    int16_t audioMin = 0;
-    arm_min_no_idx_q15((int16_t*)audioBuffer->data, audioBuffer->n_elements, &audioMin);
-
-    int16_t audioMax = 0;
-    arm_max_no_idx_q15((int16_t*)audioBuffer->data, audioBuffer->n_elements, &audioMax);
-
-    int32_t audioScale = desirableSignalSpan / (audioMax - audioMin);
-
-    /* We don't want random silence to be amplified too much; we limit
-     * the gain */
-    if (audioScale > maxScale) {
-        audioScale = maxScale;
-    } else if (audioScale < 1) {
-        audioScale = 1;
+    constexpr size_t ringSize = arm::app::windowSamples;
+    int16_t* const history    = arm::app::audioHistory;
+
+    /* Samples in the first copy go to the second one and the other way round. */
+    const size_t firstEnd = std::min(std::max(start, ringSize), start + nSamples);
+    if (start < firstEnd) {
+        std::memcpy(
+            &history[start + ringSize], &history[start], (firstEnd - start) * sizeof(int16_t));
     }
-
-    return audioScale;
-}
-
-static void ApplyGainAndOffset(audio_buf* audioBuffer, int32_t audioOffset, int32_t audioScale)
-{
-    debug("Scale: %d; Offset: %d\n", audioScale, audioOffset);
-    int16_t* buf = static_cast<int16_t*>(audioBuffer->data);
-
-    /* Apply offset first and then gain */
-    for (uint32_t i = 0; i < audioBuffer->n_elements; ++i) {
-        auto& sample         = buf[i];
-        int32_t modified_val = (static_cast<int32_t>(sample) + audioOffset) * audioScale;
-
-        /* Clip the high end */
-        modified_val = std::min<int32_t>(modified_val,
-                                         static_cast<int32_t>(std::numeric_limits<int16_t>::max()));
-
-        /* Clip the low end */
-        modified_val = std::max<int32_t>(modified_val,
-                                         static_cast<int32_t>(std::numeric_limits<int16_t>::min()));
-
-        sample = static_cast<int16_t>(modified_val);
+    if (firstEnd < start + nSamples) {
+        std::memcpy(&history[firstEnd - ringSize],
+                    &history[firstEnd],
+                    (start + nSamples - firstEnd) * sizeof(int16_t));
     }
 }
@@ -25,14 +25,24 @@
  * some heap for the API runtime.
  */
 #include "AudioUtils.hpp"
-#include "BufAttributes.hpp" /* Buffer attributes to be applied */
-#include "Classifier.hpp"    /* Classifier for the result */
-#include "InputFiles.hpp"    /* Baked-in input (not needed for live data) */
-#include "KwsProcessing.hpp" /* Pre and Post Process */
-#include "KwsResult.hpp"
-#include "Labels.hpp" /* Label Data for the model */
+#include "BufAttributes.hpp"   /* Buffer attributes to be applied */
+#include "InputFiles.hpp"      /* Baked-in input (not needed for live data) */
+#include "KeywordDetector.hpp" /* Posterior smoothing and keyword events */
+#include "KwsBatchStats.hpp"   /* Throughput and accuracy over all clips */
+#include "KwsIndexResult.hpp"  /* Allocation free KWS results */
+#include "KwsProcessing.hpp"   /* Pre and Post Process */
+#include "Labels.hpp"          /* Label Data for the model */
 #include "MicroNetKwsMfcc.hpp"
-#include "MicroNetKwsModel.hpp" /* Model API */
+#include "MicroNetKwsModel.hpp"      /* Model API */
+#include "NpuPmuCounters.hpp"        /* Ethos-U PMU counts per inference */
+#include "OpProfiler.hpp"            /* Optional per-operator timing */
+#include "RuntimeAudioClips.hpp"     /* Clips loaded by the FVP at launch */
+#include "StageProfiler.hpp"         /* Per-stage timing summary */
+#include "VoiceActivityDetector.hpp" /* Gate for windows without speech */
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 
 /* Platform dependent files */
 #include "RTE_Components.h"  /* Provides definition for CMSIS_device_header */
@@ -40,6 +50,12 @@
 #include "BoardInit.hpp"      /* Board initialisation */
 #include "log_macros.h"      /* Logging macros (optional) */
 
+#include "tensorflow/lite/micro/micro_time.h" /* Tick frequency */
+
+#if !defined(ML_TARGET_NAME)
+#define ML_TARGET_NAME "Target"
+#endif /* !defined(ML_TARGET_NAME) */
+
 namespace arm {
 namespace app {
     /* Tensor arena buffer */
@@ -57,13 +73,19 @@ namespace app {
 __asm("  .global __ARM_use_no_argv\n");
 #endif
 
+static int32_t GetLabelFromFilename(const char* filename);
+
 int main()
 {
     /* Initialise the UART module to allow printf related functions (if using retarget) */
     BoardInit();
 
     /* Model object creation and initialisation. */
+#if ML_OP_PROFILING
+    arm::app::OpProfilingModel<arm::app::MicroNetKwsModel> model;
+#else
     arm::app::MicroNetKwsModel model;
+#endif /* ML_OP_PROFILING */
     if (!model.Init(arm::app::tensorArena,
                     sizeof(arm::app::tensorArena),
                     arm::app::kws::GetModelPointer(),
@@ -101,94 +123,231 @@ int main()
      * NOTE: This is only used for time stamp calculation. */
     const float secondsPerSample = 1.0 / arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq;
 
-    /* Classifier object for results */
-    arm::app::KwsClassifier classifier;
-
-    /* Object to hold label strings. */
-    std::vector<std::string> labels;
-
-    /* Declare a container to hold results from across the whole audio clip. */
-    std::vector<arm::app::kws::KwsResult> finalResults;
+    arm::app::audio::VoiceActivityDetector vad{};
 
-    /* Object to hold classification results */
-    std::vector<arm::app::ClassificationResult> singleInfResult;
-
-    /* Populate the labels here. */
-    GetLabelsVector(labels);
-
-    /* Set up pre and post-processing. */
+    /* Set up pre-processing; post-processing computes the posteriors straight from the
+     * output tensor. */
     arm::app::KwsPreProcess preProcess = arm::app::KwsPreProcess(
         inputTensor, numMfccFeatures, numMfccFrames, mfccFrameLength, mfccFrameStride);
 
-    arm::app::KwsPostProcess postProcess =
-        arm::app::KwsPostProcess(outputTensor, classifier, labels, singleInfResult);
+    /* Posteriors are averaged over as many strides as the latency budget allows. */
+    arm::app::kws::DetectorConfig detectorConfig{};
+    detectorConfig.averageWindows = arm::app::kws::KeywordDetector::AverageWindowsForLatency(
+        KWS_LATENCY_BUDGET_MS / 1000.f, secondsPerSample * preProcess.m_audioDataStride);
+    detectorConfig.triggerThreshold = scoreThreshold;
+    arm::app::kws::KeywordDetector detector{detectorConfig};
+    float posteriors[arm::app::kws::numLabels];
 
-    /* Creating a sliding window through the whole audio clip. */
-    auto audioDataSlider =
-        arm::app::audio::SlidingWindow<const int16_t>(get_audio_array(0),
-                                                      get_audio_array_size(0),
-                                                      preProcess.m_audioDataWindowSize,
-                                                      preProcess.m_audioDataStride);
+    /* Clips injected into the runtime_ifm region at launch take precedence over the
+     * baked-in ones. */
+    arm::app::audio::RuntimeAudioClips runtimeClips;
+#if defined(RUNTIME_IFM_BASE) && defined(RUNTIME_IFM_SIZE)
+    if (runtimeClips.Init(reinterpret_cast<const void*>(RUNTIME_IFM_BASE), RUNTIME_IFM_SIZE)) {
+        const auto samplingFreq =
+            static_cast<uint32_t>(arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq);
+        if (runtimeClips.GetSampleRate() != samplingFreq) {
+            printf_err("Runtime clips sampled at %" PRIu32 " Hz; expected %" PRIu32 " Hz\n",
+                       runtimeClips.GetSampleRate(),
+                       samplingFreq);
+            return 1;
+        }
+        info("Using %" PRIu32 " audio clips loaded at run time\n", runtimeClips.GetClipCount());
+    }
+#endif /* defined(RUNTIME_IFM_BASE) && defined(RUNTIME_IFM_SIZE) */
 
-    debug("Using audio data from %s\n", get_filename(0));
+    const bool useRuntimeClips = runtimeClips.GetClipCount() > 0;
+    const uint32_t clipCount   = useRuntimeClips ? runtimeClips.GetClipCount() : NUMBER_OF_FILES;
 
-    while (audioDataSlider.HasNext()) {
-        const int16_t* inferenceWindow = audioDataSlider.Next();
+    arm::app::kws::KwsBatchStats batchStats;
+    arm::app::StageProfiler profiler;
+    const size_t vadStage         = KWS_VAD_ENABLED ? profiler.AddStage("voice activity")
+                                                    : arm::app::StageProfiler::ms_maxStages;
+    const size_t preProcessStage  = profiler.AddStage("pre-processing");
+    const size_t inferenceStage   = profiler.AddStage("inference");
+    const size_t postProcessStage = profiler.AddStage("post-processing");
 
-        info(
-            "Inference %zu/%zu\n", audioDataSlider.Index() + 1, audioDataSlider.TotalStrides() + 1);
+    for (uint32_t clipIdx = 0; clipIdx < clipCount; ++clipIdx) {
+        const int16_t* clip =
+            useRuntimeClips ? runtimeClips.GetClip(clipIdx) : get_audio_array(clipIdx);
+        const uint32_t clipSize =
+            useRuntimeClips ? runtimeClips.GetClipSize(clipIdx) : get_audio_array_size(clipIdx);
+        const int32_t expectedIdx = useRuntimeClips ? runtimeClips.GetClipLabel(clipIdx)
+                                                    : GetLabelFromFilename(get_filename(clipIdx));
 
-        /* Run the pre-processing, inference and post-processing. */
-        if (!preProcess.DoPreProcess(inferenceWindow, audioDataSlider.Index())) {
-            printf_err("Pre-processing failed.");
-            return 1;
+        if (clipSize < preProcess.m_audioDataWindowSize) {
+            warn("Skipping clip %" PRIu32 ": shorter than one window\n", clipIdx);
+            continue;
         }
 
-        if (!model.RunInference()) {
-            printf_err("Inference failed.");
-            return 2;
-        }
+        /* Every clip is independent of the previous one. */
+        vad.Reset();
+        detector.Reset();
 
-        if (!postProcess.DoPostProcess()) {
-            printf_err("Post-processing failed.");
-            return 3;
-        }
+        /* Creating a sliding window through the whole audio clip. */
+        auto audioDataSlider =
+            arm::app::audio::SlidingWindow<const int16_t>(clip,
+                                                          clipSize,
+                                                          preProcess.m_audioDataWindowSize,
+                                                          preProcess.m_audioDataStride);
 
-        /* Add results from this window to our final results vector. */
-        finalResults.emplace_back(arm::app::kws::KwsResult(
-            singleInfResult,
-            audioDataSlider.Index() * secondsPerSample * preProcess.m_audioDataStride,
-            audioDataSlider.Index(),
-            scoreThreshold));
-    } /* while (audioDataSlider.HasNext()) */
-
-    for (const auto& result : finalResults) {
-
-        std::string topKeyword{"<none>"};
-        float score = 0.f;
-        if (!result.m_resultVec.empty()) {
-            topKeyword = result.m_resultVec[0].m_label;
-            score      = result.m_resultVec[0].m_normalisedVal;
+        if (useRuntimeClips) {
+            debug("Using audio clip %" PRIu32 " loaded at run time\n", clipIdx);
+        } else {
+            debug("Using audio data from %s\n", get_filename(clipIdx));
         }
 
-        if (result.m_resultVec.empty()) {
-            info("For timestamp: %f (inference #: %" PRIu32 "); label: %s; threshold: %f\n",
-                 result.m_timeStamp,
-                 result.m_inferenceNumber,
-                 topKeyword.c_str(),
-                 result.m_threshold);
-        } else {
-            for (uint32_t j = 0; j < result.m_resultVec.size(); ++j) {
-                info("For timestamp: %f (inference #: %" PRIu32
-                     "); label: %s, score: %f; threshold: %f\n",
-                     result.m_timeStamp,
-                     result.m_inferenceNumber,
-                     result.m_resultVec[j].m_label.c_str(),
-                     result.m_resultVec[j].m_normalisedVal,
-                     result.m_threshold);
+        /* The clip is classified as its first detected keyword or, failing that, as the
+         * label with the highest posterior in any of its windows. */
+        uint32_t detectedIdx = arm::app::kws::noLabelIdx;
+        float clipMaxPosteriors[arm::app::kws::numLabels]{};
+
+        /* Features of the previous window can only be reused when it was inferred; after
+         * windows skipped by the VAD they are recomputed from scratch. */
+        bool prevInferred = false;
+
+        while (audioDataSlider.HasNext()) {
+            const int16_t* inferenceWindow = audioDataSlider.Next();
+
+            debug("Inference %zu/%zu\n",
+                  audioDataSlider.Index() + 1,
+                  audioDataSlider.TotalStrides() + 1);
+
+            arm::app::kws::KwsIndexResult result{};
+            result.timeStamp =
+                audioDataSlider.Index() * secondsPerSample * preProcess.m_audioDataStride;
+            result.inferenceNumber = audioDataSlider.Index();
+
+            bool inferred = true;
+            if (KWS_VAD_ENABLED) {
+                arm::app::ScopedStageTimer timer{profiler, vadStage};
+                inferred = vad.IsActive(inferenceWindow, preProcess.m_audioDataWindowSize);
             }
+            if (!inferred) {
+                debug("No voice activity; skipping inference\n");
+                std::fill(std::begin(posteriors), std::end(posteriors), 0.f);
+                posteriors[arm::app::kws::silenceLabelIdx] = 1.f;
+            } else {
+                /* Run the pre-processing, inference and post-processing. */
+                {
+                    arm::app::ScopedStageTimer timer{profiler, preProcessStage};
+                    if (!preProcess.DoPreProcess(inferenceWindow,
+                                                 prevInferred ? audioDataSlider.Index() : 0)) {
+                        printf_err("Pre-processing failed.");
+                        return 1;
+                    }
+                }
+
+                {
+                    arm::app::ScopedStageTimer timer{profiler, inferenceStage};
+                    if (!model.RunInference()) {
+                        printf_err("Inference failed.");
+                        return 2;
+                    }
+                }
+#if ML_OP_PROFILING
+                arm::app::OpProfilingResolver::PrintCsv(
+                    profiler.GetStats(inferenceStage).GetCount() - 1);
+#endif /* ML_OP_PROFILING */
+#if defined(ETHOSU_ARCH)
+                arm::app::PrintNpuPmuCounters(arm::app::TakeNpuPmuCounters(),
+                                              profiler.GetStats(inferenceStage).GetCount() - 1,
+                                              profiler.GetStats(inferenceStage).GetLast());
+#endif /* defined(ETHOSU_ARCH) */
+
+                {
+                    arm::app::ScopedStageTimer timer{profiler, postProcessStage};
+                    if (!arm::app::kws::GetPosteriors(outputTensor, posteriors)) {
+                        printf_err("Post-processing failed.");
+                        return 3;
+                    }
+                }
+            }
+            prevInferred = inferred;
+
+            for (uint32_t i = 0; i < arm::app::kws::numLabels; ++i) {
+                clipMaxPosteriors[i] = std::max(clipMaxPosteriors[i], posteriors[i]);
+            }
+
+            /* Raw result of this window. */
+            arm::app::kws::GetTopResult(posteriors, scoreThreshold, result);
+            if (result.labelIdx == arm::app::kws::noLabelIdx) {
+                debug("For timestamp: %f (inference #: %" PRIu32
+                      "); label: <none>; threshold: %f\n",
+                      result.timeStamp,
+                      result.inferenceNumber,
+                      scoreThreshold);
+            } else {
+                debug("For timestamp: %f (inference #: %" PRIu32
+                      "); label: %s, score: %f; threshold: %f\n",
+                      result.timeStamp,
+                      result.inferenceNumber,
+                      arm::app::kws::labelTable[result.labelIdx],
+                      result.score,
+                      scoreThreshold);
+            }
+
+            /* Keyword detected once the smoothed posteriors settle on it. */
+            arm::app::kws::KwsIndexResult event{};
+            if (detector.Update(posteriors, result.timeStamp, result.inferenceNumber, event)) {
+                info("Clip %" PRIu32 ": detected: %s at timestamp: %f (inference #: %" PRIu32
+                     "); score: %f\n",
+                     clipIdx,
+                     arm::app::kws::labelTable[event.labelIdx],
+                     event.timeStamp,
+                     event.inferenceNumber,
+                     event.score);
+                if (detectedIdx == arm::app::kws::noLabelIdx) {
+                    detectedIdx = event.labelIdx;
+                }
+            }
+
+            batchStats.AddWindow(inferred);
+        } /* while (audioDataSlider.HasNext()) */
+
+        if (detectedIdx == arm::app::kws::noLabelIdx) {
+            arm::app::kws::KwsIndexResult clipResult{};
+            arm::app::kws::GetTopResult(clipMaxPosteriors, 0.f, clipResult);
+            detectedIdx = clipResult.labelIdx;
+        }
+        batchStats.AddClip(expectedIdx, detectedIdx);
+    } /* for (clipIdx) */
+
+    profiler.PrintSummary(ML_TARGET_NAME, tflite::ticks_per_second());
+
+    /* Throughput only counts the processing stages, so that it does not depend on logging,
+     * operator profiling or PMU output. */
+    uint64_t processingTicks = 0;
+    for (const size_t stage : {vadStage, preProcessStage, inferenceStage, postProcessStage}) {
+        if (stage < arm::app::StageProfiler::ms_maxStages) {
+            processingTicks += profiler.GetStats(stage).GetTotal();
         }
     }
+    batchStats.Print(tflite::ticks_per_second(), processingTicks);
 
     return 0;
 }
+
+/**
+ * @brief   Gets the expected label of a baked-in clip from the last '_' separated part of its
+ *          file name, e.g. "down" for "ks_down.wav".
+ * @return  Label index, negative if the name does not end in a label.
+ */
+static int32_t GetLabelFromFilename(const char* filename)
+{
+    if (!filename) {
+        return -1;
+    }
+
+    const char* start = std::strrchr(filename, '_');
+    start             = start ? start + 1 : filename;
+    const char* end   = std::strrchr(start, '.');
+    const size_t len  = end ? static_cast<size_t>(end - start) : std::strlen(start);
+
+    for (uint32_t i = 0; i < arm::app::kws::numLabels; ++i) {
+        const char* label = arm::app::kws::labelTable[i];
+        if (std::strlen(label) == len && 0 == std::strncmp(label, start, len)) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
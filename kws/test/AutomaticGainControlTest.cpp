@@ -0,0 +1,203 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Host test of the automatic gain control with recorded audio. A 16-bit PCM WAV file is
+ * captured the way main_live.cpp does it: hop by hop, each hop conditioned with the current
+ * offset and gain, whose statistics then update them. The recording is played at microphone
+ * level, attenuated and with a DC bias, and looped until the estimates settle.
+ */
+#include "AudioConditioning.hpp"
+#include "AutomaticGainControl.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t hopMs      = 240; /* Default hop of main_live.cpp. */
+    constexpr int32_t attenuation = 16;
+    constexpr int32_t dcBias      = 1000;
+    constexpr uint32_t loops      = 10;
+    constexpr int32_t targetSpan  = 18000; /* AutomaticGainControl default. */
+
+    /* Largest change between consecutive hops: the gain as a ratio, the offset in LSBs. */
+    constexpr double maxGainStep    = 1.25;
+    constexpr int32_t maxOffsetStep = 16;
+
+    struct Wav {
+        uint32_t sampleRate{0};
+        uint16_t channels{0};
+        std::vector<int16_t> samples; /* Interleaved. */
+    };
+
+    uint32_t ReadLe(const uint8_t* p, size_t bytes)
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint32_t>(p[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    /* Reads an uncompressed 16-bit PCM WAV file. */
+    bool ReadWav(const char* path, Wav& wav)
+    {
+        std::ifstream file{path, std::ios::binary};
+        const std::vector<uint8_t> data{std::istreambuf_iterator<char>(file),
+                                        std::istreambuf_iterator<char>()};
+        if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 ||
+            std::memcmp(data.data() + 8, "WAVE", 4) != 0) {
+            return false;
+        }
+
+        bool pcm16 = false;
+        for (size_t pos = 12; pos + 8 <= data.size();) {
+            const uint8_t* chunk = data.data() + pos;
+            const uint32_t size  = ReadLe(chunk + 4, 4);
+            if (pos + 8 + size > data.size()) {
+                return false;
+            }
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+                pcm16 = ReadLe(chunk + 8, 2) == 1 && ReadLe(chunk + 22, 2) == 16;
+                wav.channels   = static_cast<uint16_t>(ReadLe(chunk + 10, 2));
+                wav.sampleRate = ReadLe(chunk + 12, 4);
+            } else if (std::memcmp(chunk, "data", 4) == 0 && pcm16 && wav.channels > 0) {
+                wav.samples.resize(size / 2);
+                for (size_t i = 0; i < wav.samples.size(); ++i) {
+                    wav.samples[i] = static_cast<int16_t>(ReadLe(chunk + 8 + 2 * i, 2));
+                }
+                return !wav.samples.empty();
+            }
+            pos += 8 + size + (size & 1);
+        }
+        return false;
+    }
+
+    /* Per-hop record of the estimates the hop was conditioned with. */
+    struct Hop {
+        int32_t offset;
+        int32_t gain;
+        int32_t rawSpan;
+        double conditionedMean;
+    };
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+    Wav wav;
+    if (argc < 2 || !ReadWav(argv[1], wav)) {
+        printf("Usage: %s <16-bit PCM WAV file>\n", argc > 0 ? argv[0] : "agc_test");
+        return EXIT_FAILURE;
+    }
+
+    /* First channel at microphone level, as interleaved stereo like the supported boards. */
+    std::vector<int16_t> captured;
+    for (size_t i = 0; i < wav.samples.size(); i += wav.channels) {
+        const auto sample = static_cast<int16_t>(wav.samples[i] / attenuation + dcBias);
+        captured.insert(captured.end(), {sample, sample});
+    }
+
+    const uint32_t hopFrames = wav.sampleRate * hopMs / 1000;
+    const size_t hopsPerLoop = captured.size() / 2 / hopFrames;
+    if (hopsPerLoop == 0) {
+        printf("Recording shorter than one hop\n");
+        return EXIT_FAILURE;
+    }
+
+    arm::app::audio::AutomaticGainControl agc{targetSpan};
+    arm::app::audio::AudioBlockStats stats{};
+    std::vector<int16_t> mono(hopFrames);
+    std::vector<Hop> hops;
+
+    for (uint32_t loop = 0; loop < loops; ++loop) {
+        for (size_t hop = 0; hop < hopsPerLoop; ++hop) {
+            const int32_t offset = agc.GetOffset();
+            const int32_t gain   = agc.GetGain();
+            arm::app::audio::ConditionStereoToMono(
+                &captured[2 * hop * hopFrames], mono.data(), hopFrames, offset, gain, stats);
+            agc.Update(stats);
+
+            const double sum = std::accumulate(mono.begin(), mono.end(), 0.0);
+            hops.push_back({offset, gain, stats.max - stats.min, sum / hopFrames});
+        }
+    }
+
+    bool ok = true;
+
+    /* No step change: after the first hop, which primes the estimates, both follow the
+     * signal gradually. */
+    for (size_t i = 2; i < hops.size(); ++i) {
+        const double gainStep = static_cast<double>(std::max(hops[i].gain, hops[i - 1].gain)) /
+                                std::min(hops[i].gain, hops[i - 1].gain);
+        const int32_t offsetStep = std::abs(hops[i].offset - hops[i - 1].offset);
+        if (gainStep > maxGainStep || offsetStep > maxOffsetStep) {
+            printf("Hop %zu: step from gain %d, offset %d to gain %d, offset %d\n",
+                   i,
+                   hops[i - 1].gain,
+                   hops[i - 1].offset,
+                   hops[i].gain,
+                   hops[i].offset);
+            ok = false;
+        }
+    }
+
+    /* Converged over the last loop: the offset cancels the DC bias, and the gain scales the
+     * loudest hop to the target span or, with the envelope released, a little above it. */
+    const auto lastLoop = hops.end() - hopsPerLoop;
+    const int32_t loudestSpan =
+        std::max_element(lastLoop, hops.end(), [](const Hop& a, const Hop& b) {
+            return a.rawSpan < b.rawSpan;
+        })->rawSpan;
+    const double gainFloor = static_cast<double>(targetSpan) / loudestSpan;
+
+    for (auto hop = lastLoop; hop != hops.end(); ++hop) {
+        const double gain =
+            static_cast<double>(hop->gain) / (1 << arm::app::audio::ms_gainFracBits);
+        if (std::abs(hop->offset + dcBias) > 4) {
+            printf("Offset %d did not converge to %d\n", hop->offset, -dcBias);
+            ok = false;
+        }
+        if (gain < 0.95 * gainFloor || gain > 1.5 * gainFloor) {
+            printf("Gain %.3f did not converge to %.3f-%.3f\n", gain, gainFloor, 1.5 * gainFloor);
+            ok = false;
+        }
+        if (std::abs(hop->conditionedMean) > 0.01 * targetSpan) {
+            printf("Conditioned audio has a DC level of %.1f\n", hop->conditionedMean);
+            ok = false;
+        }
+    }
+
+    printf("%zu hops of %" PRIu32 " frames: offset %d, gain %.3f after %" PRIu32 " loops: %s\n",
+           hops.size(),
+           hopFrames,
+           hops.back().offset,
+           static_cast<double>(hops.back().gain) / (1 << arm::app::audio::ms_gainFracBits),
+           loops,
+           ok ? "PASS" : "FAIL");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
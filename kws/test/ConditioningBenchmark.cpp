@@ -0,0 +1,154 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * Host micro-benchmark of the live audio conditioning: the fused scalar path of
+ * ConditionStereoToMono against the separate ApplyGainAndOffset and ConvertToMono loops it
+ * replaced in main_live.cpp. Both are run over one second of stereo audio; the outputs must
+ * be identical. The fused path also gathers the statistics for the automatic gain control,
+ * which used to take separate mean, min and max passes over the captured audio, so the old
+ * loops are reported with and without such a pass.
+ */
+#include "AudioConditioning.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t frames     = 16000; /* One second at 16 kHz. */
+    constexpr uint32_t iterations = 500;
+    constexpr int32_t offset      = -300;
+    constexpr int32_t gain        = 5 << arm::app::audio::ms_gainFracBits;
+
+    /* The loops replaced by ConditionStereoToMono, with the gain in the same fixed point
+     * format. The first one works in place on the whole stereo buffer. */
+    void ApplyGainAndOffset(int16_t* buf,
+                            uint32_t nElements,
+                            int32_t audioOffset,
+                            int32_t audioScale)
+    {
+        for (uint32_t i = 0; i < nElements; ++i) {
+            auto& sample = buf[i];
+            int32_t modified_val =
+                ((static_cast<int32_t>(sample) + audioOffset) * audioScale) >>
+                arm::app::audio::ms_gainFracBits;
+
+            /* Clip the high end */
+            modified_val = std::min<int32_t>(
+                modified_val, static_cast<int32_t>(std::numeric_limits<int16_t>::max()));
+
+            /* Clip the low end */
+            modified_val = std::max<int32_t>(
+                modified_val, static_cast<int32_t>(std::numeric_limits<int16_t>::min()));
+
+            sample = static_cast<int16_t>(modified_val);
+        }
+    }
+
+    void ConvertToMono(const int16_t* stereo, uint32_t nElements, int16_t* mono)
+    {
+        for (uint32_t j = 0; j < nElements; j += 2, stereo += 2) {
+            *mono++ = ((stereo[0] >> 1) + (stereo[1] >> 1));
+        }
+    }
+
+    /* Mean, min and max of the raw stereo samples in one pass, as the old gain control
+     * computed them with arm_mean_q15, arm_min_no_idx_q15 and arm_max_no_idx_q15. */
+    void BlockStats(const int16_t* buf, uint32_t nElements, arm::app::audio::AudioBlockStats& stats)
+    {
+        int32_t sum = 0;
+        int16_t min = std::numeric_limits<int16_t>::max();
+        int16_t max = std::numeric_limits<int16_t>::min();
+        for (uint32_t i = 0; i < nElements; ++i) {
+            sum += buf[i];
+            min = std::min(min, buf[i]);
+            max = std::max(max, buf[i]);
+        }
+        stats = {sum, nElements, min, max};
+    }
+
+    /* Runs fn the given number of times and returns the best time per frame in ns. */
+    template <typename Fn>
+    double BestNsPerFrame(Fn&& fn)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const auto stop = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+        return best / frames;
+    }
+
+} /* namespace */
+
+int main()
+{
+    /* Speech-like levels with the occasional sample that saturates once scaled. */
+    std::vector<int16_t> captured(2 * frames);
+    std::mt19937 rng{1};
+    std::normal_distribution<float> level{0.f, 2000.f};
+    for (auto& sample : captured) {
+        sample = static_cast<int16_t>(std::clamp(level(rng), -32768.f, 32767.f));
+    }
+
+    std::vector<int16_t> scratch(captured.size());
+    std::vector<int16_t> monoOld(frames);
+    std::vector<int16_t> monoNew(frames);
+    arm::app::audio::AudioBlockStats statsOld{};
+    arm::app::audio::AudioBlockStats statsNew{};
+
+    const double oldNs = BestNsPerFrame([&]() {
+        std::copy(captured.begin(), captured.end(), scratch.begin());
+        ApplyGainAndOffset(scratch.data(), scratch.size(), offset, gain);
+        ConvertToMono(scratch.data(), scratch.size(), monoOld.data());
+    });
+    const double statsNs =
+        BestNsPerFrame([&]() { BlockStats(captured.data(), captured.size(), statsOld); });
+    const double copyNs = BestNsPerFrame(
+        [&]() { std::copy(captured.begin(), captured.end(), scratch.begin()); });
+    const double newNs = BestNsPerFrame([&]() {
+        arm::app::audio::ConditionStereoToMono(
+            captured.data(), monoNew.data(), frames, offset, gain, statsNew);
+    });
+
+    if (monoOld != monoNew || statsOld.sum != statsNew.sum || statsOld.count != statsNew.count ||
+        statsOld.min != statsNew.min || statsOld.max != statsNew.max) {
+        printf("ConditionStereoToMono does not match the separate loops\n");
+        return EXIT_FAILURE;
+    }
+
+    /* The separate loops modified the DMA buffer in place, so the copy restoring the input
+     * between runs is not part of their cost. */
+    printf("Stereo to mono conditioning of %" PRIu32 " frames, best of %" PRIu32 " runs:\n",
+           frames,
+           iterations);
+    printf("  ApplyGainAndOffset + ConvertToMono:         %6.3f ns/frame\n", oldNs - copyNs);
+    printf("  ApplyGainAndOffset + ConvertToMono + stats: %6.3f ns/frame\n",
+           oldNs - copyNs + statsNs);
+    printf("  ConditionStereoToMono (scalar, with stats): %6.3f ns/frame\n", newNs);
+    return EXIT_SUCCESS;
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: Copyright 2022 Arm Limited and/or its
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
  * affiliates <open-source-office@arm.com>
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,40 +16,19 @@
  * limitations under the License.
  */
 
-#include "BufAttributes.hpp"
+/* Host stand-in for the CMSIS-DSP header: only what the scalar paths of the kws sources
+ * use, so they can be built and measured on the host. */
+#ifndef HOST_ARM_MATH_H
+#define HOST_ARM_MATH_H
 
-#include <string>
-#include <vector>
+#include <cstdint>
 
-static const char* labelsVec[] LABELS_ATTRIBUTE = {
-    "down",
-    "go",
-    "left",
-    "no",
-    "off",
-    "on",
-    "right",
-    "stop",
-    "up",
-    "yes",
-    "_silence_",
-    "_unknown_",
-};
-
-bool GetLabelsVector(std::vector<std::string>& labels)
+/* Saturates a signed value to the given number of bits, like the SSAT instruction. */
+static inline int32_t __SSAT(int32_t val, uint32_t sat)
 {
-    constexpr size_t labelsSz = 12;
-    labels.clear();
-
-    if (!labelsSz) {
-        return false;
-    }
-
-    labels.reserve(labelsSz);
-
-    for (size_t i = 0; i < labelsSz; ++i) {
-        labels.emplace_back(labelsVec[i]);
-    }
-
-    return true;
+    const int32_t max = static_cast<int32_t>((1U << (sat - 1U)) - 1U);
+    const int32_t min = -1 - max;
+    return val > max ? max : (val < min ? min : val);
 }
+
+#endif /* HOST_ARM_MATH_H */
@@ -32,7 +32,16 @@ uint32_t GetCurrentTimeTicks() { return 0; }
 
 #else
 
-uint32_t ticks_per_second() { return 0; }
+// Both the DWT and the PMU cycle counters count core clock cycles. Without a
+// cycle counter GetCurrentTimeTicks() returns 0, so report timing as unsupported.
+uint32_t ticks_per_second() {
+#if (!defined(TF_LITE_STRIP_ERROR_STRINGS) && !defined(ARMCM0) && \
+     !defined(ARMCM0plus))
+  return SystemCoreClock;
+#else
+  return 0;
+#endif
+}
 
 uint32_t GetCurrentTimeTicks() {
   static bool is_initialized = false;
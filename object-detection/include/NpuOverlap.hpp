@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NPU_OVERLAP_HPP
+#define NPU_OVERLAP_HPP
+
+#include "TensorFlowLiteMicro.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * CPU work that can run while the NPU executes an inference. With wait false the job must
+     * not block: it does what the data available allows and returns false to be called again
+     * later. With wait true it must run to completion and return true.
+     */
+    using OverlapJob = bool (*)(void* arg, bool wait);
+
+    /**
+     * @brief       Submits a job to run on the CPU the next time the Ethos-U driver waits for
+     *              a command stream to complete, i.e. while the NPU is busy with the following
+     *              RunInference(), and again on every wake-up during that wait until it is
+     *              done. The job must not touch the model's tensors.
+     *              Only one job can be pending; a new one replaces the previous.
+     * @param[in]   job   Job to run.
+     * @param[in]   arg   Argument passed to the job.
+     */
+    void SubmitOverlapJob(OverlapJob job, void* arg);
+
+    /**
+     * @brief   Waits for the submitted job: runs what is left of it now, blocking as the job
+     *          needs, e.g. for data that was not available while the NPU was busy or because
+     *          the model had no NPU operators.
+     * @return  true if (part of) the job had to be run here, false if it had already
+     *          completed in the background or nothing was submitted.
+     */
+    bool WaitOverlapJob();
+
+    /**
+     * @brief   Two-slot scheme for a model input: the pre-processing writes into the spare slot
+     *          through a tensor view of it while the NPU reads the other slot through the real
+     *          input tensor, and the two slots swap right before the next inference.
+     *          Both slots live outside the tensor arena, whose input region the inference may
+     *          reuse for intermediate tensors.
+     */
+    class DoubleBufferedInput {
+    public:
+        /**
+         * @param[in]   inputTensor   Model input tensor; its data is moved to the first slot.
+         * @param[in]   slot0         First slot.
+         * @param[in]   slot1         Second slot.
+         * @param[in]   slotSize      Size of each slot in bytes, at least inputTensor->bytes.
+         */
+        DoubleBufferedInput(TfLiteTensor* inputTensor,
+                            uint8_t* slot0,
+                            uint8_t* slot1,
+                            size_t slotSize);
+
+        /** @brief  Checks the slots are large enough for the input tensor. */
+        bool IsValid() const;
+
+        /** @brief  Gets a tensor identical to the input tensor but backed by the spare slot. */
+        TfLiteTensor* GetSpareTensor() { return &this->m_spareTensor; }
+
+        /** @brief  Hands the spare slot to the input tensor and takes its slot back as the
+         *          spare one; call before RunInference(). */
+        void Commit();
+
+    private:
+        TfLiteTensor* m_inputTensor;
+        TfLiteTensor m_spareTensor;
+        size_t m_slotSize;
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* NPU_OVERLAP_HPP */
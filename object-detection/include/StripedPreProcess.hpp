@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STRIPED_PRE_PROCESS_HPP
+#define STRIPED_PRE_PROCESS_HPP
+
+#include "TensorFlowLiteMicro.hpp"
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Row range counterpart of DetectorPreProcess: converts and quantises horizontal
+     *          stripes of an image into the input tensor as they arrive, applying the same
+     *          conversions DetectorPreProcess::DoPreProcess applies to the whole image.
+     *          Stripes can come in any order; together they must cover every row once.
+     */
+    class StripedPreProcess {
+    public:
+        /**
+         * @param[in]   inputTensor     Tensor the rows are written to.
+         * @param[in]   imgHeight       Number of rows of the image and of the tensor.
+         * @param[in]   rgb2Gray        Convert RGB888 input to grayscale.
+         * @param[in]   convertToInt8   Convert the result to int8 for signed models.
+         */
+        StripedPreProcess(TfLiteTensor* inputTensor,
+                          uint32_t imgHeight,
+                          bool rgb2Gray,
+                          bool convertToInt8);
+
+        /**
+         * @brief       Pre-processes a stripe of rows of an image.
+         * @param[in]   imageData  Start of the whole image, not of the stripe.
+         * @param[in]   firstRow   First row of the stripe.
+         * @param[in]   numRows    Number of rows in the stripe.
+         * @return      true on success, false if the stripe is outside the image.
+         */
+        bool DoPreProcessRows(const void* imageData, uint32_t firstRow, uint32_t numRows);
+
+    private:
+        TfLiteTensor* m_inputTensor;
+        uint32_t m_imgHeight;
+        bool m_rgb2Gray;
+        bool m_convertToInt8;
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* STRIPED_PRE_PROCESS_HPP */
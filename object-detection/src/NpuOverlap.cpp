@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NpuOverlap.hpp"
+
+#include "RTE_Components.h"  /* Provides definition for CMSIS_device_header */
+#include CMSIS_device_header /* For __WFE */
+
+#include <new>
+#include <utility>
+
+namespace {
+
+    volatile arm::app::OverlapJob s_job{nullptr};
+    void* s_jobArg{nullptr};
+
+    /* Runs the pending job, if any, and keeps it pending if it is not done yet. */
+    bool RunPendingJob(bool wait)
+    {
+        const arm::app::OverlapJob job = s_job;
+        if (!job) {
+            return false;
+        }
+        s_job = nullptr;
+        if (!job(s_jobArg, wait)) {
+            s_job = job;
+        }
+        return true;
+    }
+
+    /* Same counting semaphore as the driver's default bare-metal implementation. */
+    struct Semaphore {
+        volatile uint32_t count;
+    };
+
+} /* namespace */
+
+/* The Ethos-U driver waits for the end of each command stream by taking a semaphore that
+ * its interrupt handler gives. Overriding the weak semaphore functions lets the CPU run the
+ * submitted job while it would otherwise sleep in that wait. */
+extern "C" {
+
+void* ethosu_semaphore_create(void)
+{
+    return new (std::nothrow) Semaphore{0};
+}
+
+void ethosu_semaphore_destroy(void* sem)
+{
+    delete static_cast<Semaphore*>(sem);
+}
+
+int ethosu_semaphore_take(void* sem, uint64_t /* timeout */)
+{
+    auto* s = static_cast<Semaphore*>(sem);
+
+    /* The job never blocks here, so it cannot hold up the return to the caller once the NPU
+     * is done; whatever it could not do yet is retried on the next wake-up. */
+    while (s->count == 0) {
+        RunPendingJob(false);
+        if (s->count == 0) {
+            __WFE();
+        }
+    }
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    --s->count;
+    __set_PRIMASK(primask);
+    return 0;
+}
+
+int ethosu_semaphore_give(void* sem)
+{
+    auto* s = static_cast<Semaphore*>(sem);
+
+    /* Also given from the NPU interrupt handler: leave the interrupt mask as it was. */
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ++s->count;
+    __set_PRIMASK(primask);
+    __SEV();
+    return 0;
+}
+
+} /* extern "C" */
+
+namespace arm {
+namespace app {
+
+    void SubmitOverlapJob(OverlapJob job, void* arg)
+    {
+        s_jobArg = arg;
+        s_job    = job;
+    }
+
+    bool WaitOverlapJob()
+    {
+        return RunPendingJob(true);
+    }
+
+    DoubleBufferedInput::DoubleBufferedInput(TfLiteTensor* inputTensor,
+                                             uint8_t* slot0,
+                                             uint8_t* slot1,
+                                             size_t slotSize)
+        : m_inputTensor{inputTensor}, m_spareTensor{*inputTensor}, m_slotSize{slotSize}
+    {
+        this->m_inputTensor->data.data = slot0;
+        this->m_spareTensor.data.data  = slot1;
+    }
+
+    bool DoubleBufferedInput::IsValid() const
+    {
+        return this->m_inputTensor->data.data && this->m_spareTensor.data.data &&
+               this->m_inputTensor->bytes <= this->m_slotSize;
+    }
+
+    void DoubleBufferedInput::Commit()
+    {
+        std::swap(this->m_inputTensor->data.data, this->m_spareTensor.data.data);
+    }
+
+} /* namespace app */
+} /* namespace arm */
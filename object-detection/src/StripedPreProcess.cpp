@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its
+ * affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StripedPreProcess.hpp"
+
+#include "ImageUtils.hpp"
+#include "log_macros.h"
+
+#include <cinttypes>
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    StripedPreProcess::StripedPreProcess(TfLiteTensor* inputTensor,
+                                         uint32_t imgHeight,
+                                         bool rgb2Gray,
+                                         bool convertToInt8)
+        : m_inputTensor{inputTensor}, m_imgHeight{imgHeight}, m_rgb2Gray{rgb2Gray},
+          m_convertToInt8{convertToInt8}
+    {}
+
+    bool StripedPreProcess::DoPreProcessRows(const void* imageData,
+                                             uint32_t firstRow,
+                                             uint32_t numRows)
+    {
+        if (imageData == nullptr || this->m_imgHeight == 0 || firstRow > this->m_imgHeight ||
+            numRows > this->m_imgHeight - firstRow) {
+            printf_err("Invalid stripe of %" PRIu32 " rows at row %" PRIu32 "\n",
+                       numRows,
+                       firstRow);
+            return false;
+        }
+
+        /* Rows are contiguous in both the image and the tensor, so a stripe is just a
+         * shorter image to the whole-image conversions. */
+        const size_t dstRowSize = this->m_inputTensor->bytes / this->m_imgHeight;
+        const size_t srcRowSize = this->m_rgb2Gray ? dstRowSize * 3 : dstRowSize;
+        const auto* src = static_cast<const uint8_t*>(imageData) + firstRow * srcRowSize;
+        uint8_t* dst    = this->m_inputTensor->data.uint8 + firstRow * dstRowSize;
+
+        if (this->m_rgb2Gray) {
+            image::RgbToGrayscale(src, dst, numRows * dstRowSize);
+        } else {
+            std::memcpy(dst, src, numRows * dstRowSize);
+        }
+
+        if (this->m_convertToInt8) {
+            image::ConvertImgToInt8(dst, numRows * dstRowSize);
+        }
+
+        return true;
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -30,6 +30,9 @@
 #include "DetectorPostProcessing.hpp" /* Post Process */
 #include "DetectorPreProcessing.hpp"  /* Pre Process */
 #include "InputFiles.hpp"             /* Baked-in input (not needed for live data) */
+#include "NpuPmuCounters.hpp"         /* Ethos-U PMU counts per inference */
+#include "OpProfiler.hpp"             /* Optional per-operator timing */
+#include "StageProfiler.hpp"          /* Per-stage timing summary */
 #include "YoloFastestModel.hpp"       /* Model API */
 #include "main_video.h"
 
@@ -38,6 +41,12 @@
 #include CMSIS_device_header /* Gives us IRQ num, base addresses. */
 #include "log_macros.h"      /* Logging macros (optional) */
 
+#include "tensorflow/lite/micro/micro_time.h" /* Tick frequency */
+
+#if !defined(ML_TARGET_NAME)
+#define ML_TARGET_NAME "Target"
+#endif /* !defined(ML_TARGET_NAME) */
+
 namespace arm {
 namespace app {
     /* Tensor arena buffer */
@@ -58,7 +67,11 @@ __asm("  .global __ARM_use_no_argv\n");
 int app_main()
 {
     /* Model object creation and initialisation. */
+#if ML_OP_PROFILING
+    arm::app::OpProfilingModel<arm::app::YoloFastestModel> model;
+#else
     arm::app::YoloFastestModel model;
+#endif /* ML_OP_PROFILING */
     if (!model.Init(arm::app::tensorArena,
                     sizeof(arm::app::tensorArena),
                     arm::app::object_detection::GetModelPointer(),
@@ -100,6 +113,11 @@ int app_main()
     arm::app::DetectorPostProcess postProcess =
         arm::app::DetectorPostProcess(outputTensor0, outputTensor1, results, postProcessParams);
 
+    arm::app::StageProfiler profiler;
+    const size_t preProcessStage  = profiler.AddStage("pre-processing");
+    const size_t inferenceStage   = profiler.AddStage("inference");
+    const size_t postProcessStage = profiler.AddStage("post-processing");
+
     /* Strings for presentation/logging. */
     std::string str_inf{"Running inference... "};
 
@@ -110,22 +128,38 @@ int app_main()
         inputTensor->bytes < IMAGE_DATA_SIZE ? inputTensor->bytes : IMAGE_DATA_SIZE;
 
     /* Run the pre-processing, inference and post-processing. */
-    if (!preProcess.DoPreProcess(currImage, copySz)) {
-        printf_err("Pre-processing failed.");
-        return 1;
+    {
+        arm::app::ScopedStageTimer timer{profiler, preProcessStage};
+        if (!preProcess.DoPreProcess(currImage, copySz)) {
+            printf_err("Pre-processing failed.");
+            return 1;
+        }
     }
 
     /* Run inference over this image. */
     info("Running inference on image %" PRIu32 " => %s\n", 0, get_filename(0));
 
-    if (!model.RunInference()) {
-        printf_err("Inference failed.");
-        return 2;
+    {
+        arm::app::ScopedStageTimer timer{profiler, inferenceStage};
+        if (!model.RunInference()) {
+            printf_err("Inference failed.");
+            return 2;
+        }
     }
-
-    if (!postProcess.DoPostProcess()) {
-        printf_err("Post-processing failed.");
-        return 3;
+#if ML_OP_PROFILING
+    arm::app::OpProfilingResolver::PrintCsv(0);
+#endif /* ML_OP_PROFILING */
+#if defined(ETHOSU_ARCH)
+    arm::app::PrintNpuPmuCounters(
+        arm::app::TakeNpuPmuCounters(), 0, profiler.GetStats(inferenceStage).GetLast());
+#endif /* defined(ETHOSU_ARCH) */
+
+    {
+        arm::app::ScopedStageTimer timer{profiler, postProcessStage};
+        if (!postProcess.DoPostProcess()) {
+            printf_err("Post-processing failed.");
+            return 3;
+        }
     }
 
     /* Log the results. */
@@ -141,5 +175,7 @@ int app_main()
 
     results.clear();
 
+    profiler.PrintSummary(ML_TARGET_NAME, tflite::ticks_per_second());
+
     return 0;
 }
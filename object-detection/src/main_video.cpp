@@ -29,6 +29,9 @@
 #include "DetectionResult.hpp"
 #include "DetectorPostProcessing.hpp" /* Post Process */
 #include "DetectorPreProcessing.hpp"  /* Pre Process */
+#include "NpuOverlap.hpp"             /* Pre-processing overlapped with inference */
+#include "StageProfiler.hpp"          /* Latency statistics */
+#include "StripedPreProcess.hpp"      /* Pre-processing of partially captured frames */
 #include "YoloFastestModel.hpp"       /* Model API */
 #include "main_video.h"
 
@@ -38,20 +41,56 @@
 #include "log_macros.h"      /* Logging macros (optional) */
 #include "video_drv.h"       /* Video Driver API */
 
+#include <cstring>
+
 #define IMAGE_WIDTH     192
 #define IMAGE_HEIGHT    192
 #define IMAGE_SIZE      (IMAGE_WIDTH * IMAGE_HEIGHT * 3)
 
+/* Number of frames in the video input ring. The application holds a frame while it is
+ * pre-processed, drawn on and sent to the display, and the capture pauses while the next
+ * slot is held, so two frames keep the pipeline going. More frames only let the capture run
+ * ahead, at the cost of a frame of SRAM each. */
+#define INPUT_FRAME_COUNT   2
+
+/* Horizontal stripes each input frame is transferred in; stripes are pre-processed as they
+ * arrive. 1 transfers whole frames. Must divide IMAGE_HEIGHT. */
+#ifndef INPUT_FRAME_SLICES
+#define INPUT_FRAME_SLICES  4
+#endif
+
+/* Set to 1 to have the video input deliver frames already in the model's quantized input
+ * format, skipping the pre-processing. Frames then hold tensor data and are not displayed. */
+#ifndef INPUT_NATIVE_TENSOR
+#define INPUT_NATIVE_TENSOR 0
+#endif
+
+/* Longest wait for a captured frame before giving up, in microseconds. */
+#define FRAME_TIMEOUT_US    1000000U
+
+/* Video feeds processed round-robin on the NPU, feed n reading from input channel n and
+ * displaying on output channel n. Two feeds need the video driver built with
+ * VIDEO_INPUT_CHANNELS and VIDEO_OUTPUT_CHANNELS set to 2. */
+#ifndef VIDEO_INPUT_FEEDS
+#define VIDEO_INPUT_FEEDS   1
+#endif
+#if (VIDEO_INPUT_FEEDS < 1) || (VIDEO_INPUT_FEEDS > 2)
+#error "VIDEO_INPUT_FEEDS must be 1 or 2"
+#endif
+
 namespace arm {
 namespace app {
     /* Tensor arena buffer */
     static uint8_t tensorArena[ACTIVATION_BUF_SZ] ACTIVATION_BUF_ATTRIBUTE;
 
-    /* RGB image buffer - cropped/scaled version of the original + debayered. */
-    static uint8_t rgbImage[IMAGE_SIZE];
+    /* RGB image rings, one per feed - cropped/scaled versions of the original + debayered,
+     * filled continuously by the video input. Frames are drawn on in place and lent to the
+     * video output, so there is no separate LCD buffer. */
+    static uint8_t rgbImage[VIDEO_INPUT_FEEDS][INPUT_FRAME_COUNT * IMAGE_SIZE];
 
-    /* LCD image buffer */
-    static uint8_t lcdImage[IMAGE_SIZE];
+    /* Input slots: the NPU reads one while the next frame is pre-processed into the other.
+     * Aligned as the NPU requires for tensor data. */
+    static uint8_t inputSlotBuffers[2][IMAGE_SIZE] __attribute__((aligned(16)));
 
     /* Optional getter function for the model pointer and its size. */
     namespace object_detection {
@@ -63,10 +102,41 @@ namespace app {
 
 typedef arm::app::object_detection::DetectionResult OdResults;
 
+/* Video input and output channel of each feed. */
+static const uint32_t feedInput[2]  = {VIDEO_DRV_IN0, VIDEO_DRV_IN1};
+static const uint32_t feedOutput[2] = {VIDEO_DRV_OUT0, VIDEO_DRV_OUT1};
+
+/* State of the pre-processing of the next frame, run while the NPU works on the current one. */
+struct NextFrameJob {
+    arm::app::DetectorPreProcess* preProcess;
+    arm::app::StripedPreProcess* stripes;
+    size_t imgSz;
+    uint32_t feed;              /* Feed the frame is taken from. */
+    VideoDrv_Capture_t capture; /* Frame being captured, pre-processed up to rowsDone. */
+    uint32_t rowsDone;
+    VideoDrv_Frame_t frame;     /* Acquired input frame, drawn on and displayed next iteration. */
+    int32_t waitStatus;
+    bool ok;
+};
+
+/**
+ * @brief Waits for the next captured frame of the job's feed, acquires it and pre-processes
+ *        it into the spare input slot. If no complete frame is waiting, the frame being
+ *        captured is pre-processed stripe by stripe while its slices come in. The frame stays
+ *        in the video input ring until the video output has displayed it.
+ *        Without wait, only slices and frames already captured are pre-processed and the
+ *        job returns false when it has to be called again for the rest.
+ *
+ * @param[in,out] arg    NextFrameJob.
+ * @param[in]     wait   Whether to wait for the capture.
+ * @return        true once the job is done.
+ */
+static bool PreProcessNextFrame(void* arg, bool wait);
+
 /**
  * @brief Draws a boxes in the image using the object detection results vector.
  *
- * @param[out] rgbImage     Pointer to the start of the image.
+ * @param[out] rgbImage     Pointer to the start of the image, nullptr to only print them.
  * @param[in]  width        Image width.
  * @param[in]  height       Image height.
  * @param[in]  results      Vector of object detection results.
@@ -107,9 +177,21 @@ int app_main()
     const int inputImgCols = inputShape->data[arm::app::YoloFastestModel::ms_inputColsIdx];
     const int inputImgRows = inputShape->data[arm::app::YoloFastestModel::ms_inputRowsIdx];
 
+    /* Frames are pre-processed into the spare slot while the NPU reads the input tensor. */
+    arm::app::DoubleBufferedInput inputSlots{inputTensor,
+                                             arm::app::inputSlotBuffers[0],
+                                             arm::app::inputSlotBuffers[1],
+                                             sizeof(arm::app::inputSlotBuffers[0])};
+    if (!inputSlots.IsValid()) {
+        printf_err("Input slot buffers are insufficient\n");
+        return 3;
+    }
+
     /* Set up pre and post-processing. */
     arm::app::DetectorPreProcess preProcess =
-        arm::app::DetectorPreProcess(inputTensor, true, model.IsDataSigned());
+        arm::app::DetectorPreProcess(inputSlots.GetSpareTensor(), true, model.IsDataSigned());
+    arm::app::StripedPreProcess stripePreProcess = arm::app::StripedPreProcess(
+        inputSlots.GetSpareTensor(), IMAGE_HEIGHT, true, model.IsDataSigned());
 
     std::vector<OdResults> results;
     const arm::app::object_detection::PostProcessParams postProcessParams{
@@ -124,90 +206,147 @@ int app_main()
     const size_t imgSz = inputTensor->bytes < IMAGE_SIZE ?
                          inputTensor->bytes : IMAGE_SIZE;
 
-    if (sizeof(arm::app::lcdImage) < imgSz) {
-        printf_err("RGB buffer is insufficient\n");
-        return 3;
-    }
-
     /* Initialize Video Interface */
     if (VideoDrv_Initialize(NULL) != VIDEO_DRV_OK) {
         printf_err("Failed to initialise video driver\n");
         return 1;
     }
 
-    /* Configure Input Video */
-    if (VideoDrv_Configure(VIDEO_DRV_IN0,  IMAGE_WIDTH, IMAGE_HEIGHT, VIDEO_DRV_COLOR_RGB888, 60U) != VIDEO_DRV_OK) {
-        printf_err("Failed to configure video input\n");
-        return 1;
-    }
-    /* Configure Output Video */
-    if (VideoDrv_Configure(VIDEO_DRV_OUT0, IMAGE_WIDTH, IMAGE_HEIGHT, VIDEO_DRV_COLOR_RGB888, 60U) != VIDEO_DRV_OK) {
-        printf_err("Failed to configure video output\n");
-        return 1;
-    }
+    for (uint32_t feed = 0; feed < VIDEO_INPUT_FEEDS; feed++) {
+        const uint32_t inChannel  = feedInput[feed];
+        const uint32_t outChannel = feedOutput[feed];
 
-    /* Set Input Video buffer */
-    if (VideoDrv_SetBuf(VIDEO_DRV_IN0,  arm::app::rgbImage, IMAGE_SIZE) != VIDEO_DRV_OK) {
-        printf_err("Failed to set buffer for video input\n");
-        return 1;
-    }
-    /* Set Output Video buffer */
-    if (VideoDrv_SetBuf(VIDEO_DRV_OUT0, arm::app::lcdImage, IMAGE_SIZE) != VIDEO_DRV_OK) {
-        printf_err("Failed to set buffer for video output\n");
-        return 1;
-    }
+        /* Configure Input Video */
+        if (VideoDrv_Configure(inChannel,  IMAGE_WIDTH, IMAGE_HEIGHT, VIDEO_DRV_COLOR_RGB888, 60U) != VIDEO_DRV_OK) {
+            printf_err("Failed to configure video input\n");
+            return 1;
+        }
+        /* Configure Output Video */
+        if (VideoDrv_Configure(outChannel, IMAGE_WIDTH, IMAGE_HEIGHT, VIDEO_DRV_COLOR_RGB888, 60U) != VIDEO_DRV_OK) {
+            printf_err("Failed to configure video output\n");
+            return 1;
+        }
 
-    /* Start video capture (single frame) */
-    if (VideoDrv_StreamStart(VIDEO_DRV_IN0, VIDEO_DRV_MODE_SINGLE) != VIDEO_DRV_OK) {
-        printf_err("Failed to start video capture\n");
-        return 1;
-    }
+#if INPUT_NATIVE_TENSOR
+        /* Deliver input frames in the layout and quantization of the input tensor */
+        const arm::app::QuantParams inputQuantParams = arm::app::GetTensorQuantParams(inputTensor);
+        const int inputImgChannels =
+            inputShape->data[arm::app::YoloFastestModel::ms_inputChannelsIdx];
+        const VideoDrv_TensorDesc_t tensorDesc{
+            static_cast<uint32_t>(inputImgChannels == 1 ? VIDEO_DRV_TENSOR_GRAYSCALE
+                                                        : VIDEO_DRV_TENSOR_RGB),
+            model.IsDataSigned() ? 1U : 0U,
+            inputQuantParams.offset,
+            inputQuantParams.scale};
+        if ((inputImgChannels != 1 && inputImgChannels != 3) ||
+            inputTensor->bytes !=
+                static_cast<size_t>(IMAGE_WIDTH * IMAGE_HEIGHT * inputImgChannels)) {
+            printf_err("Video input does not match the input tensor\n");
+            return 1;
+        }
+        if (VideoDrv_ConfigureTensor(inChannel, &tensorDesc) != VIDEO_DRV_OK) {
+            printf_err("Failed to configure video input tensor format\n");
+            return 1;
+        }
+        const uint32_t inputBufSize = INPUT_FRAME_COUNT * ((inputTensor->bytes + 3U) & ~3U);
+#else
+        /* Deliver input frames in stripes */
+        if (VideoDrv_SetSlices(inChannel, INPUT_FRAME_SLICES) != VIDEO_DRV_OK) {
+            printf_err("Failed to set slices for video input\n");
+            return 1;
+        }
+        const uint32_t inputBufSize = sizeof(arm::app::rgbImage[feed]);
+#endif /* INPUT_NATIVE_TENSOR */
 
-    auto dstPtr = static_cast<uint8_t*>(inputTensor->data.uint8);
+        /* Set Input Video buffer */
+        if (VideoDrv_SetBuf(inChannel,  arm::app::rgbImage[feed], inputBufSize) != VIDEO_DRV_OK) {
+            printf_err("Failed to set buffer for video input\n");
+            return 1;
+        }
+
+        /* Start video capture (continuous, into the input ring) */
+        if (VideoDrv_StreamStart(inChannel, VIDEO_DRV_MODE_CONTINUOS) != VIDEO_DRV_OK) {
+            printf_err("Failed to start video capture\n");
+            return 1;
+        }
+    }
 
     uint32_t imgCount = 0;
 
+    /* Frames dropped by the video inputs and next capture sequence number expected per feed. */
+    uint32_t droppedFrames                   = 0;
+    uint32_t nextSequence[VIDEO_INPUT_FEEDS] = {};
+
     void *rgbFrame;
-    void *lcdFrame;
 
-    while (true) {
-        VideoDrv_Status_t status;
+    /* Capture-to-result latency, in microseconds. */
+    arm::app::StageStats latencyUs;
+    /* Zero when the driver has no timestamp counter: no latency is reported then. */
+    const uint64_t timestampFreq = VideoDrv_GetTimestampFreq();
+    uint64_t captureTime;
 
-        results.clear();
+    /* The first frame is pre-processed up front; from then on, each frame is pre-processed
+     * while the NPU runs the inference of the previous one. */
+    NextFrameJob nextFrame{
+        &preProcess, &stripePreProcess, imgSz, 0, {}, 0, {}, VIDEO_DRV_OK, false};
+    PreProcessNextFrame(&nextFrame, true);
 
-        /* Wait for video input frame */
-        do {
-            status = VideoDrv_GetStatus(VIDEO_DRV_IN0);
-        } while (status.buf_empty != 0U);
+    while (true) {
+        if (nextFrame.waitStatus == VIDEO_DRV_ERROR_TIMEOUT) {
+            printf_err("Timed out waiting for a video frame\n");
+            return 1;
+        } else if (nextFrame.waitStatus != VIDEO_DRV_OK) {
+            printf_err("Video input stopped\n");
+            return 1;
+        } else if (!nextFrame.ok) {
+            printf_err("Pre-processing failed.\n");
+            return 1;
+        }
 
-        /* Get input video frame buffer */
-        rgbFrame = VideoDrv_GetFrameBuf(VIDEO_DRV_IN0);
-        /* Get output video frame buffer */
-        lcdFrame = VideoDrv_GetFrameBuf(VIDEO_DRV_OUT0);
+        results.clear();
 
-        /* Copy image frame */
-        memcpy(lcdFrame, rgbFrame, IMAGE_SIZE);
+        /* Input video frame, already acquired and pre-processed */
+        rgbFrame    = nextFrame.frame.buf;
+        captureTime = nextFrame.frame.timestamp;
 
-        /* Release input frame */
-        VideoDrv_ReleaseFrame(VIDEO_DRV_IN0);
+        const uint32_t feed      = nextFrame.feed;
+        const uint32_t inChannel = feedInput[feed];
 
-        /* Start video capture (single frame) */
-        if (VideoDrv_StreamStart(VIDEO_DRV_IN0, VIDEO_DRV_MODE_SINGLE) != VIDEO_DRV_OK) {
-            printf_err("Failed to start video capture\n");
-            return 1;
-        }
+        /* Gaps in a feed's capture sequence are frames missed while the application held
+         * its whole input ring. */
+        droppedFrames += nextFrame.frame.sequence - nextSequence[feed];
+        nextSequence[feed] = nextFrame.frame.sequence + 1;
 
-        /* Run the pre-processing, inference and post-processing. */
-        if (!preProcess.DoPreProcess(lcdFrame, imgSz)) {
-            printf_err("Pre-processing failed.\n");
-            return 1;
-        }
+#if INPUT_NATIVE_TENSOR
+        /* The frame already is the model input: copy it in and return it to the ring. */
+        std::memcpy(inputTensor->data.data, rgbFrame, inputTensor->bytes);
+        VideoDrv_ReleaseFrame(inChannel);
+#else
+        /* Hand the pre-processed frame to the input tensor, freeing the other slot. */
+        inputSlots.Commit();
+#endif /* INPUT_NATIVE_TENSOR */
 
         /* Run inference over this image. */
         if (!(imgCount++ & 0xF)) {
-            printf("\rImage %" PRIu32 "; ", imgCount);
+            if (timestampFreq == 0) {
+                printf("\rImage %" PRIu32 "; dropped %" PRIu32 "; ", imgCount, droppedFrames);
+            } else {
+                printf("\rImage %" PRIu32 "; dropped %" PRIu32 "; latency p50 %" PRIu32
+                       " us, p99 %" PRIu32 " us, max %" PRIu32 " us; ",
+                       imgCount,
+                       droppedFrames,
+                       latencyUs.GetPercentile(50),
+                       latencyUs.GetPercentile(99),
+                       latencyUs.GetMax());
+            }
         }
 
+        /* The next frame, from the next feed, is captured and pre-processed while the NPU runs. */
+        nextFrame.ok       = false;
+        nextFrame.feed     = (nextFrame.feed + 1) % VIDEO_INPUT_FEEDS;
+        nextFrame.rowsDone = 0;
+        arm::app::SubmitOverlapJob(PreProcessNextFrame, &nextFrame);
+
         if (!model.RunInference()) {
             printf_err("Inference failed.\n");
             return 2;
@@ -218,19 +357,103 @@ int app_main()
             return 3;
         }
 
-        /* Draw detection boxes to output frame buffer */
-        DrawDetectionBoxes((uint8_t *)lcdFrame, inputImgCols, inputImgRows, results);
+        /* Results are in: the frame has made it from capture to detections. */
+        if (timestampFreq != 0) {
+            latencyUs.Add(static_cast<uint32_t>(
+                ((VideoDrv_GetTimestamp() - captureTime) * 1000000U) / timestampFreq));
+        }
 
-        /* Release output frame */
-        VideoDrv_ReleaseFrame(VIDEO_DRV_OUT0);
+#if INPUT_NATIVE_TENSOR
+        /* No image to draw on; just report the detections */
+        DrawDetectionBoxes(nullptr, inputImgCols, inputImgRows, results);
+#else
+        /* Draw detection boxes onto the input frame */
+        DrawDetectionBoxes((uint8_t *)rgbFrame, inputImgCols, inputImgRows, results);
+
+        /* Hand the frame over to the feed's video output once the previous one has been sent;
+         * the driver returns it to the input ring when the output is done with it. */
+        const uint32_t outChannel = feedOutput[feed];
+        int32_t lendStatus;
+        while ((lendStatus = VideoDrv_LendFrame(inChannel, rgbFrame, outChannel)) ==
+               VIDEO_DRV_ERROR_BUSY) {
+            __WFE();
+        }
+        if (lendStatus != VIDEO_DRV_OK) {
+            printf_err("Failed to pass frame to video output\n");
+            return 1;
+        }
 
         /* Start video output (single frame) */
-        VideoDrv_StreamStart(VIDEO_DRV_OUT0, VIDEO_DRV_MODE_SINGLE);
+        VideoDrv_StreamStart(outChannel, VIDEO_DRV_MODE_SINGLE);
+#endif /* INPUT_NATIVE_TENSOR */
+
+        /* Finish the next frame here, waiting for the rest of it to be captured. */
+        arm::app::WaitOverlapJob();
     }
 
     return 0;
 }
 
+static bool PreProcessNextFrame(void* arg, bool wait)
+{
+    auto* job                = static_cast<NextFrameJob*>(arg);
+    const uint32_t inChannel = feedInput[job->feed];
+    const uint32_t timeoutUs = wait ? FRAME_TIMEOUT_US : 0U;
+
+#if INPUT_NATIVE_TENSOR
+    /* Nothing to pre-process: the frame is copied into the input tensor as it is. */
+    job->waitStatus = VideoDrv_WaitFrame(inChannel, &job->frame, timeoutUs);
+    if (!wait && job->waitStatus == VIDEO_DRV_ERROR_TIMEOUT) {
+        return false;
+    }
+    job->ok = (job->waitStatus == VIDEO_DRV_OK);
+    return true;
+#endif /* INPUT_NATIVE_TENSOR */
+
+    constexpr uint32_t rowsPerSlice = IMAGE_HEIGHT / INPUT_FRAME_SLICES;
+
+    /* Pre-process the frame being captured stripe by stripe while no complete frame waits. */
+    while (job->rowsDone < (INPUT_FRAME_SLICES - 1) * rowsPerSlice &&
+           VideoDrv_GetFrameBuf(inChannel) == nullptr) {
+        const uint32_t sequence = job->capture.sequence;
+        const int32_t status    = VideoDrv_WaitSlices(
+            inChannel, job->rowsDone / rowsPerSlice + 1, &job->capture, timeoutUs);
+        if (!wait && status == VIDEO_DRV_ERROR_TIMEOUT) {
+            return false;
+        }
+        if (status != VIDEO_DRV_OK) {
+            break;
+        }
+        if (job->capture.sequence != sequence) {
+            /* The capture moved on to a newer frame; start over on that one. */
+            job->rowsDone = 0;
+        }
+        const uint32_t rows = job->capture.slices * rowsPerSlice;
+        if (!job->stripes->DoPreProcessRows(
+                job->capture.buf, job->rowsDone, rows - job->rowsDone)) {
+            job->rowsDone = 0;
+            break;
+        }
+        job->rowsDone = rows;
+    }
+
+    job->waitStatus = VideoDrv_WaitFrame(inChannel, &job->frame, timeoutUs);
+    if (!wait && job->waitStatus == VIDEO_DRV_ERROR_TIMEOUT) {
+        return false;
+    }
+    if (job->waitStatus != VIDEO_DRV_OK) {
+        job->ok = false;
+    } else if (job->rowsDone != 0 && job->frame.sequence == job->capture.sequence &&
+               job->frame.buf == job->capture.buf) {
+        /* Only the last stripe is left. */
+        job->ok = job->stripes->DoPreProcessRows(
+            job->frame.buf, job->rowsDone, IMAGE_HEIGHT - job->rowsDone);
+    } else {
+        job->ok = job->preProcess->DoPreProcess(job->frame.buf, job->imgSz);
+    }
+    return true;
+}
+
 /**
  * @brief Draws a box in the image using the object detection result object.
  *
@@ -281,7 +504,9 @@ static void DrawDetectionBoxes(uint8_t* rgbImage,
                                const std::vector<OdResults>& results)
 {
     for (const auto& result : results) {
-        DrawBox(rgbImage, imageWidth, imageHeight, result);
+        if (rgbImage) {
+            DrawBox(rgbImage, imageWidth, imageHeight, result);
+        }
         printf("Detection :: [%" PRIu32 ", %" PRIu32
                          ", %" PRIu32 ", %" PRIu32 "]\n",
                 result.m_x0,